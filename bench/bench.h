@@ -0,0 +1,32 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Ölçüm programlarının ortak çıktısı. BENCH_JSON bir dosya yolu ise her sonuç
+// o dosyaya tek satırlık bir JSON nesnesi olarak eklenir (make bench
+// bench/results.jsonl üretir); iki sürüm bench/compare.sh ile karşılaştırılır.
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+// params aynı ölçümün farklı ayarlarını ayırır ("stages=4" gibi), NULL olabilir
+static inline void bench_json(const char *bench, const char *metric, const char *params, double value,
+                              const char *unit) {
+    const char *path = getenv("BENCH_JSON");
+    if (!path || !path[0]) return;
+    const char *rev = getenv("BENCH_REV");
+    char line[512];
+    int len = snprintf(line, sizeof(line),
+                       "{\"bench\": \"%s\", \"metric\": \"%s\", \"params\": \"%s\", \"value\": %.6g, "
+                       "\"unit\": \"%s\", \"rev\": \"%s\", \"time\": %lld}\n",
+                       bench, metric, params ? params : "", value, unit, rev ? rev : "", (long long)time(NULL));
+    if (len <= 0 || (size_t)len >= sizeof(line)) return;
+    // O_APPEND: çatallanan ölçüm süreçleri aynı dosyaya satır bölmeden yazabilir
+    int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd < 0) return;
+    if (write(fd, line, (size_t)len) != len) perror("bench_json");
+    close(fd);
+}
+
+#endif
@@ -0,0 +1,96 @@
+// @file -z için sıkıştırıcı verimi ve paylaşımlı bellekte kazanılan yer.
+// Kullanım: bench_compress [dosya] [iterasyon]
+// Dosya verilmezse sentetik bir günlük üretilir.
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "compress.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Tipik bir servis günlüğüne benzeyen metin
+static unsigned char *make_log(size_t *len) {
+    static const char *const levels[] = { "INFO", "INFO", "INFO", "WARN", "DEBUG", "ERROR" };
+    static const char *const paths[] = { "/api/users", "/api/orders", "/health", "/api/search?q=term", "/static/app.js" };
+    size_t capacity = 8 << 20;
+    unsigned char *buffer = malloc(capacity);
+    size_t used = 0;
+    unsigned seed = 1;
+    for (long i = 0; used + 256 < capacity; i++) {
+        seed = seed * 1103515245 + 12345;
+        used += snprintf((char *)buffer + used, capacity - used,
+                         "2026-10-17 12:%02ld:%02ld.%03u %-5s worker[%u] %s status=%u latency=%ums bytes=%u\n",
+                         (i / 600) % 60, (i / 10) % 60, seed % 1000, levels[seed % 6], (seed >> 8) % 16,
+                         paths[(seed >> 4) % 5], (seed >> 12) % 7 ? 200 : 500, (seed >> 16) % 250, (seed >> 3) % 65536);
+    }
+    *len = used;
+    return buffer;
+}
+
+static unsigned char *read_file(const char *path, size_t *len) {
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        perror(path);
+        exit(1);
+    }
+    fseek(f, 0, SEEK_END);
+    long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    unsigned char *buffer = malloc(size > 0 ? size : 1);
+    *len = fread(buffer, 1, size, f);
+    fclose(f);
+    return buffer;
+}
+
+int main(int argc, char **argv) {
+    size_t len;
+    unsigned char *src = argc > 1 ? read_file(argv[1], &len) : make_log(&len);
+    int iterations = argc > 2 ? atoi(argv[2]) : 20;
+
+    size_t capacity = lz_compress_bound(len);
+    unsigned char *packed = malloc(capacity);
+    unsigned char *unpacked = malloc(len);
+    size_t packed_len = 0;
+
+    double start = now_sec();
+    for (int i = 0; i < iterations; i++) packed_len = lz_compress(src, len, packed, capacity);
+    double compress_time = now_sec() - start;
+
+    start = now_sec();
+    int ok = 1;
+    for (int i = 0; i < iterations; i++) ok &= lz_decompress(packed, packed_len, unpacked, len) == 0;
+    double decompress_time = now_sec() - start;
+
+    start = now_sec();
+    for (int i = 0; i < iterations; i++) memcpy(unpacked, src, len);
+    double copy_time = now_sec() - start;
+
+    if (!ok || memcmp(src, unpacked, len) != 0) {
+        fprintf(stderr, "round trip failed\n");
+        return 1;
+    }
+
+    double mb = (double)len * iterations / 1e6;
+    printf("input: %zu bytes, compressed: %zu bytes, ratio: %.2fx\n", len, packed_len, (double)len / packed_len);
+    printf("plain copy:  %8.1f MB/s\n", mb / copy_time);
+    printf("compress:    %8.1f MB/s\n", mb / compress_time);
+    printf("decompress:  %8.1f MB/s\n", mb / decompress_time);
+    bench_json("compress", "compress", NULL, mb / compress_time, "MB/s");
+    bench_json("compress", "decompress", NULL, mb / decompress_time, "MB/s");
+    bench_json("compress", "ratio", NULL, (double)len / packed_len, "x");
+    // Aynı shm bütçesine sığan dosya sayısı (örnek: 64 MB)
+    size_t budget = 64u << 20;
+    printf("files of this size per 64 MB of shm: %zu plain, %zu compressed\n", budget / len, budget / packed_len);
+
+    free(src);
+    free(packed);
+    free(unpacked);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Komut geçmişi: ekleme hızı, açılışta dosyadan yükleme ve önek araması gecikmesi.
+// Kullanım: bench_history [komut sayısı]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "bench.h"
+#include "history.h"
+
+static const char *const commands[] = {
+    "ls -la", "git status", "git commit -m", "make -j8", "cd ..", "grep -rn", "cat", "vim",
+    "ssh build@server", "docker run --rm -it", "@msg", "@file", "echo", "history", "python3 -m",
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Up tuşunu en eskiye kadar basılı tutmak gibi: önekle eşleşen tüm komutlar
+static double time_walk(History *history, const char *prefix, size_t *matches) {
+    double start = now_sec();
+    *matches = 0;
+    int64_t seq = (int64_t)history_end(history);
+    while ((seq = history_prev(history, prefix, (uint64_t)seq)) >= 0) (*matches)++;
+    return (now_sec() - start) * 1e6;
+}
+
+static double time_first(History *history, const char *prefix) {
+    int rounds = 10000;
+    volatile int64_t seq = 0;
+    double start = now_sec();
+    for (int i = 0; i < rounds; i++) seq = history_prev(history, prefix, history_end(history) - (uint64_t)i);
+    (void)seq;
+    return (now_sec() - start) / rounds * 1e6;
+}
+
+int main(int argc, char **argv) {
+    long count = argc > 1 ? atol(argv[1]) : 100000;
+    size_t command_count = sizeof(commands) / sizeof(commands[0]);
+    char path[] = "/tmp/bench_history.XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0) return 1;
+    close(fd);
+
+    History *history = history_new((size_t)count, path);
+    unsigned seed = 1;
+    double start = now_sec();
+    for (long i = 0; i < count; i++) {
+        char command[128];
+        seed = seed * 1103515245 + 12345;
+        snprintf(command, sizeof(command), "%s file%ld.c", commands[(seed >> 16) % command_count], i);
+        history_add(history, command);
+    }
+    double elapsed = now_sec() - start;
+    printf("added %ld commands in %.3f s: %.0f commands/s\n", count, elapsed, count / elapsed);
+    bench_json("history", "add", NULL, count / elapsed, "commands/s");
+    history_free(history);
+
+    start = now_sec();
+    history = history_new((size_t)count, path);
+    double load_ms = (now_sec() - start) * 1e3;
+    printf("loaded %llu commands from file in %.1f ms\n",
+           (unsigned long long)(history_end(history) - history_begin(history)), load_ms);
+    bench_json("history", "load", NULL, load_ms, "ms");
+
+    static const char *const prefixes[] = { "g", "git commit", "ssh build@server fi", "make -j8 file9999", "none" };
+    for (size_t i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+        size_t matches;
+        double walk = time_walk(history, prefixes[i], &matches);
+        double first = time_first(history, prefixes[i]);
+        printf("prefix %-22s %7zu matches  first %6.2f us  walk all %9.1f us\n", prefixes[i], matches, first, walk);
+        char params[64];
+        snprintf(params, sizeof(params), "prefix=%s", prefixes[i]);
+        bench_json("history", "first_match", params, first, "us");
+    }
+    history_free(history);
+    unlink(path);
+    return 0;
+}
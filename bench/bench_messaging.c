@@ -0,0 +1,121 @@
+// Mesaj halkası mikro ölçümü, tek süreç içinde:
+//  - gidiş-dönüş: A model_send_message yapar, B model_read_messages ile görene kadar döner
+//  - çekişme: N iş parçacığı (her biri kendi Model'iyle) aynı halkaya aynı anda yazar
+// Süreçler arası teslim gecikmesi için bench_users'a bakın.
+// Kullanım: bench_messaging [mesaj sayısı] [en fazla yazar]
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "model.h"
+
+typedef struct {
+    Model *model;
+    int messages;
+    _Atomic int *start;
+    int writers;
+    uint32_t *samples; // Gönderim başına nanosaniye
+} Writer;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+static void on_message(const MessageEntry *entry, void *data) {
+    (*(int *)data)++;
+}
+
+static void round_trip(int messages) {
+    Model *sender = model_init("Ping");
+    Model *receiver = model_init("Pong");
+    int seen = 0;
+    model_read_messages(receiver, on_message, &seen); // Önceden kalanları atla
+
+    uint32_t *samples = malloc(sizeof(uint32_t) * messages);
+    for (int i = 0; i < messages; i++) {
+        seen = 0;
+        uint64_t start = now_ns();
+        model_send_message(sender, "ping");
+        while (seen == 0) model_read_messages(receiver, on_message, &seen);
+        samples[i] = (uint32_t)(now_ns() - start);
+    }
+    qsort(samples, messages, sizeof(uint32_t), compare_u32);
+    fprintf(stderr, "round trip: p50 %u ns  p99 %u ns  max %u ns  (%d messages)\n", samples[messages / 2],
+            samples[(size_t)messages * 99 / 100], samples[messages - 1], messages);
+    bench_json("messaging", "round_trip_p50", NULL, samples[messages / 2], "ns");
+    bench_json("messaging", "round_trip_p99", NULL, samples[(size_t)messages * 99 / 100], "ns");
+    free(samples);
+    model_destroy(receiver);
+    model_destroy(sender);
+}
+
+static void *writer_main(void *arg) {
+    Writer *writer = arg;
+    atomic_fetch_add(writer->start, 1);
+    while (atomic_load(writer->start) < writer->writers) {}
+    for (int i = 0; i < writer->messages; i++) {
+        uint64_t start = now_ns();
+        model_send_message(writer->model, "contended message body");
+        writer->samples[i] = (uint32_t)(now_ns() - start);
+    }
+    return NULL;
+}
+
+static void contention(int writers, int messages) {
+    Writer *list = calloc(writers, sizeof(Writer));
+    pthread_t *threads = calloc(writers, sizeof(pthread_t));
+    uint32_t *samples = malloc(sizeof(uint32_t) * (size_t)writers * messages);
+    _Atomic int start = 0;
+    // Halkayı ilk kuran model en son kapanmalı, o yüzden ayrı tutulur
+    Model *owner = model_init("Owner");
+    for (int i = 0; i < writers; i++) {
+        char username[MAX_USERNAME];
+        snprintf(username, sizeof(username), "Writer%d", i + 1);
+        list[i] = (Writer){ model_init(username), messages, &start, writers, samples + (size_t)i * messages };
+    }
+
+    uint64_t begin = now_ns();
+    for (int i = 0; i < writers; i++) pthread_create(&threads[i], NULL, writer_main, &list[i]);
+    for (int i = 0; i < writers; i++) pthread_join(threads[i], NULL);
+    double elapsed = (now_ns() - begin) / 1e9;
+
+    size_t count = (size_t)writers * messages;
+    qsort(samples, count, sizeof(uint32_t), compare_u32);
+    double rate = count / elapsed;
+    fprintf(stderr, "%7d %12.0f %10u %10u\n", writers, rate, samples[count / 2], samples[count * 99 / 100]);
+    char params[32];
+    snprintf(params, sizeof(params), "writers=%d", writers);
+    bench_json("messaging", "send_rate", params, rate, "messages/s");
+    bench_json("messaging", "send_p99", params, samples[count * 99 / 100], "ns");
+
+    for (int i = 0; i < writers; i++) model_destroy(list[i].model);
+    model_destroy(owner);
+    free(samples);
+    free(threads);
+    free(list);
+}
+
+int main(int argc, char **argv) {
+    int messages = argc > 1 ? atoi(argv[1]) : 100000;
+    int max_writers = argc > 2 ? atoi(argv[2]) : 8;
+
+    // Kalıcı günlüğü ve geçmişi kirletmesin, modelin printf'leri ölçümü boğmasın
+    setenv("TERMINAL_MSG_LOG", "", 1);
+    setenv("TERMINAL_HISTORY_FILE", "", 1);
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+
+    round_trip(messages);
+    fprintf(stderr, "%7s %12s %10s %10s\n", "writers", "messages/s", "p50 ns", "p99 ns");
+    for (int writers = 1; writers <= max_writers; writers *= 2) contention(writers, messages);
+    return 0;
+}
@@ -0,0 +1,55 @@
+// Ayrıştırıcı verimi: saniyede kaç komut satırı AST'ye çevrilebiliyor.
+// Kullanım: bench_parse [iterasyon]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "parser.h"
+
+static const char *const commands[] = {
+    "ls -la",
+    "echo \"hello world\" > out.txt",
+    "cat < input.txt 2>errors.log | grep -v '^#' | sort | uniq -c | sort -rn | head -20",
+    "make -j8 && ./terminal || echo 'build failed' >> build.log",
+    "find . -name '*.c' -exec wc -l {} +",
+    "git log --oneline --graph --decorate --all | less",
+    "cd /tmp; mkdir -p a/b/c && touch a/b/c/file\\ with\\ spaces",
+    "gcc -Wall -Wextra -O2 -g -I. -Iinclude -DNDEBUG -o app main.c util.c parser.c model.c view.c controller.c -lm -lpthread",
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char **argv) {
+    long iterations = argc > 1 ? atol(argv[1]) : 1000000;
+    size_t count = sizeof(commands) / sizeof(commands[0]);
+    size_t bytes = 0;
+    long stages = 0;
+
+    Parser *parser = parser_new();
+    double start = now_sec();
+    for (long i = 0; i < iterations; i++) {
+        const char *input = commands[i % count];
+        CommandLine *line = parser_parse(parser, input);
+        if (!line) {
+            fprintf(stderr, "parse error: %s: %s\n", input, parser_error(parser));
+            return 1;
+        }
+        for (Pipeline *p = line->pipelines; p; p = p->next) stages += p->stage_count;
+        bytes += strlen(input);
+        parser_reset(parser);
+    }
+    double elapsed = now_sec() - start;
+    parser_free(parser);
+
+    printf("commands: %ld, stages: %ld, elapsed: %.3f s\n", iterations, stages, elapsed);
+    printf("parse throughput: %.0f commands/s (%.1f MB/s)\n", iterations / elapsed, bytes / elapsed / 1e6);
+    bench_json("parse", "throughput", NULL, iterations / elapsed, "commands/s");
+    bench_json("parse", "latency", NULL, elapsed / iterations * 1e9, "ns");
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Boru hattı verimi: spawn katmanıyla kurulan N aşamalı "cat | cat | ..." zincirinden
+// saniyede kaç MB geçiyor. Denetleyicinin dış komutlar için kurduğu düzenin aynısı:
+// aşamalar arası pipe2(O_CLOEXEC), her aşama posix_spawn ile doğrudan exec.
+// Kullanım: bench_pipeline [MB] [en fazla aşama]
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "bench.h"
+#include "spawner.h"
+
+#define CHUNK (64 * 1024)
+
+typedef struct {
+    int fd;
+    size_t total;
+} Writer;
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void *writer_main(void *arg) {
+    Writer *writer = arg;
+    static char chunk[CHUNK];
+    memset(chunk, 'x', sizeof(chunk));
+    for (size_t i = 63; i < sizeof(chunk); i += 64) chunk[i] = '\n';
+    size_t left = writer->total;
+    while (left > 0) {
+        ssize_t n = write(writer->fd, chunk, left < CHUNK ? left : CHUNK);
+        if (n <= 0) break;
+        left -= (size_t)n;
+    }
+    close(writer->fd);
+    return NULL;
+}
+
+// Zinciri kurar, total baytı baştan yazıp sondan okur; MB/s döner
+static double run(int stages, size_t total) {
+    char *const cat_argv[] = { "cat", NULL };
+    pid_t pids[64];
+    int input[2];
+    if (pipe2(input, O_CLOEXEC) == -1) return 0;
+    int prev = input[0];
+    for (int i = 0; i < stages; i++) {
+        int out[2];
+        if (pipe2(out, O_CLOEXEC) == -1) return 0;
+        SpawnRequest req;
+        spawn_request_init(&req);
+        req.argv = cat_argv;
+        req.stdin_fd = prev;
+        req.stdout_fd = out[1];
+        pids[i] = spawn_process(&req);
+        close(prev);
+        close(out[1]);
+        prev = out[0];
+    }
+
+    Writer writer = { input[1], total };
+    pthread_t thread;
+    double start = now_sec();
+    pthread_create(&thread, NULL, writer_main, &writer);
+    static char buffer[CHUNK];
+    size_t received = 0;
+    ssize_t n;
+    while ((n = read(prev, buffer, sizeof(buffer))) > 0) received += (size_t)n;
+    double elapsed = now_sec() - start;
+    pthread_join(thread, NULL);
+    close(prev);
+    for (int i = 0; i < stages; i++) waitpid(pids[i], NULL, 0);
+    if (received != total) {
+        fprintf(stderr, "pipeline lost data: %zu of %zu bytes\n", received, total);
+        return 0;
+    }
+    return total / elapsed / 1e6;
+}
+
+int main(int argc, char **argv) {
+    size_t total = (size_t)(argc > 1 ? atol(argv[1]) : 256) << 20;
+    int max_stages = argc > 2 ? atoi(argv[2]) : 8;
+    if (max_stages > 64) max_stages = 64;
+
+    printf("%6s %10s   (%zu MB through cat)\n", "stages", "MB/s", total >> 20);
+    for (int stages = 1; stages <= max_stages; stages *= 2) {
+        double mbs = run(stages, total);
+        printf("%6d %10.0f\n", stages, mbs);
+        char params[32];
+        snprintf(params, sizeof(params), "stages=%d", stages);
+        bench_json("pipeline", "throughput", params, mbs, "MB/s");
+    }
+    return 0;
+}
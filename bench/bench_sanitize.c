@@ -0,0 +1,101 @@
+// Çıktı temizleyici: farklı girdi türlerinde her komut kümesi için MB/s.
+// Kullanım: bench_sanitize [MB]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "sanitize.h"
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void fill_pieces(char *buf, size_t size, const char *const *pieces, size_t count) {
+    unsigned seed = 1;
+    size_t len = 0;
+    while (len < size) {
+        seed = seed * 1103515245 + 12345;
+        const char *piece = pieces[(seed >> 16) % count];
+        size_t n = strlen(piece);
+        if (n > size - len) n = size - len;
+        memcpy(buf + len, piece, n);
+        len += n;
+    }
+}
+
+static void sink(const char *text, size_t len, const TextStyle *style, void *data) {
+    *(size_t *)data += len;
+}
+
+static double run(const char *buf, size_t size) {
+    Sanitizer *sanitizer = sanitizer_new();
+    size_t out = 0;
+    double start = now_sec();
+    // Borudan okunan parçalar gibi 4 KB'lık dilimler
+    for (size_t off = 0; off < size; off += 4096) {
+        sanitizer_feed(sanitizer, buf + off, size - off < 4096 ? size - off : 4096, sink, &out);
+    }
+    double elapsed = now_sec() - start;
+    sanitizer_free(sanitizer);
+    return size / elapsed / 1e6;
+}
+
+int main(int argc, char **argv) {
+    size_t size = (size_t)(argc > 1 ? atol(argv[1]) : 64) << 20;
+    static const char *const log_lines[] = {
+        "2024-05-01 12:00:01 INFO server started on port 8080\n",
+        "2024-05-01 12:00:02 WARN cache miss ratio 0.42\n",
+        "gcc -Wall -g -c model.c\n",
+        "    at com.example.Main.run(Main.java:42)\n",
+    };
+    static const char *const utf8_words[] = {
+        "çalıştırılıyor ", "günlük ", "dosya ", "şifre ", "Ünite ", "test ", "日本語 ", "ok\n", "€ ", "😀 ",
+    };
+    static const char *const color_lines[] = {
+        "\x1b[0m\x1b[01;34mbench\x1b[0m  ", "\x1b[01;32mterminal\x1b[0m  ", "model.c  ", "view.c\n",
+        "\x1b[01;31m\x1b[Kerror\x1b[m\x1b[K: expected ';'\n", "\x1b[38;5;208mwarn\x1b[0m ",
+    };
+
+    struct {
+        const char *name;
+        char *buf;
+    } inputs[4];
+    inputs[0].name = "ascii log";
+    inputs[1].name = "utf-8 text";
+    inputs[2].name = "ansi color";
+    inputs[3].name = "random binary";
+    for (int i = 0; i < 4; i++) inputs[i].buf = malloc(size);
+    fill_pieces(inputs[0].buf, size, log_lines, sizeof(log_lines) / sizeof(log_lines[0]));
+    fill_pieces(inputs[1].buf, size, utf8_words, sizeof(utf8_words) / sizeof(utf8_words[0]));
+    fill_pieces(inputs[2].buf, size, color_lines, sizeof(color_lines) / sizeof(color_lines[0]));
+    unsigned seed = 7;
+    for (size_t i = 0; i < size; i++) {
+        seed = seed * 1103515245 + 12345;
+        inputs[3].buf[i] = (char)(seed >> 16);
+    }
+
+    static const char *const isas[] = { "scalar", "sse2", "avx2" };
+    printf("%-14s", "input");
+    for (size_t k = 0; k < 3; k++) printf(" %10s", isas[k]);
+    printf("   (MB/s, %zu MB each)\n", size >> 20);
+    for (int i = 0; i < 4; i++) {
+        printf("%-14s", inputs[i].name);
+        for (size_t k = 0; k < 3; k++) {
+            if (sanitize_select(isas[k]) == -1) printf(" %10s", "n/a");
+            else {
+                double mbs = run(inputs[i].buf, size);
+                char params[64];
+                snprintf(params, sizeof(params), "input=%s,isa=%s", inputs[i].name, isas[k]);
+                bench_json("sanitize", "throughput", params, mbs, "MB/s");
+                printf(" %10.0f", mbs);
+            }
+        }
+        printf("\n");
+        free(inputs[i].buf);
+    }
+    return 0;
+}
@@ -0,0 +1,67 @@
+// @search dizini: mesaj ekleme hızı ve büyük geçmişte sorgu gecikmesi.
+// Kullanım: bench_search [mesaj sayısı]
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "search.h"
+
+static const char *const words[] = {
+    "build", "failed", "deploy", "server", "restart", "ok", "thanks", "log", "error", "warning",
+    "merge", "review", "branch", "test", "passed", "release", "tonight", "lunch", "meeting", "docs",
+    "kernel", "patch", "memory", "leak", "cache", "latency", "disk", "full", "backup", "done",
+};
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static double time_query(SearchIndex *index, const char *query, size_t *matches) {
+    uint64_t results[20];
+    int rounds = 200;
+    double start = now_sec();
+    for (int i = 0; i < rounds; i++) *matches = search_query(index, query, results, 20);
+    return (now_sec() - start) / rounds * 1e6;
+}
+
+int main(int argc, char **argv) {
+    long count = argc > 1 ? atol(argv[1]) : 500000;
+    size_t word_count = sizeof(words) / sizeof(words[0]);
+    SearchIndex *index = search_new();
+    unsigned seed = 1;
+    size_t bytes = 0;
+
+    double start = now_sec();
+    for (long i = 0; i < count; i++) {
+        char text[256];
+        int len = 0;
+        int n = 4 + (int)(seed % 8);
+        for (int w = 0; w < n; w++) {
+            seed = seed * 1103515245 + 12345;
+            len += snprintf(text + len, sizeof(text) - len, "%s ", words[(seed >> 16) % word_count]);
+        }
+        // Her mesajda bir de nadir kelime (ör. bilet numarası)
+        len += snprintf(text + len, sizeof(text) - len, "ticket%ld", i % 5000);
+        search_add(index, (uint64_t)i, text, (size_t)len);
+        bytes += len;
+    }
+    double elapsed = now_sec() - start;
+    printf("indexed %ld messages (%.1f MB) in %.3f s: %.0f messages/s\n", count, bytes / 1e6, elapsed, count / elapsed);
+    bench_json("search", "index", NULL, count / elapsed, "messages/s");
+
+    static const char *const queries[] = { "ticket42", "build failed", "kernel memory leak", "server restart ticket7" };
+    for (size_t i = 0; i < sizeof(queries) / sizeof(queries[0]); i++) {
+        size_t matches = 0;
+        double us = time_query(index, queries[i], &matches);
+        printf("query %-24s %8zu matches  %9.1f us\n", queries[i], matches, us);
+        char params[64];
+        snprintf(params, sizeof(params), "query=%s", queries[i]);
+        bench_json("search", "query", params, us, "us");
+    }
+    search_free(index);
+    return 0;
+}
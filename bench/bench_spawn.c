@@ -0,0 +1,113 @@
+// Spawn gecikmesi: eski yol (GTK sürecini fork -> fork -> sh -c) ile
+// spawn katmanının (posix_spawn, doğrudan exec) ve model_execute_command'ın
+// (boru + sh -c + çıktıyı EOF'a kadar okuma) karşılaştırması.
+// Günlük LOG_LEVEL ile derleme anında kapalıdır (varsayılan 0): ölçümde
+// stdio maliyeti yoktur. LOG_LEVEL=4 ile derlenirse satırlar arka plan
+// iş parçacığına gider ve sayılara o yük de girer.
+// Kullanım: bench_spawn [iterasyon] [yığın_MB]
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "bench.h"
+#include "model.h"
+#include "spawner.h"
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Eski controller yolu: arayüz süreci fork edilir, çocuk model_execute_command
+// içinde tekrar fork eder ve "sh -c" çalıştırır
+static void old_path(const char *command) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        pid_t inner = fork();
+        if (inner == 0) {
+            execlp("sh", "sh", "-c", command, (char *)NULL);
+            _exit(127);
+        }
+        waitpid(inner, NULL, 0);
+        _exit(0);
+    }
+    waitpid(pid, NULL, 0);
+}
+
+static void spawn_path(char *const argv[]) {
+    SpawnRequest req;
+    spawn_request_init(&req);
+    req.argv = argv;
+    pid_t pid = spawn_process(&req);
+    if (pid > 0) waitpid(pid, NULL, 0);
+}
+
+static void shell_path(const char *command) {
+    SpawnRequest req;
+    spawn_request_init(&req);
+    req.shell_command = command;
+    pid_t pid = spawn_process(&req);
+    if (pid > 0) waitpid(pid, NULL, 0);
+}
+
+int main(int argc, char **argv) {
+    int iterations = argc > 1 ? atoi(argv[1]) : 500;
+    size_t heap_mb = argc > 2 ? (size_t)atoi(argv[2]) : 64;
+
+    // GTK sürecinin yığınını taklit et: sayfalara dokun ki fork kopyalasın
+    size_t heap_size = heap_mb << 20;
+    char *heap = malloc(heap_size);
+    if (heap) memset(heap, 1, heap_size);
+
+    char *const true_argv[] = { "true", NULL };
+    double t0, old_us, spawn_us, shell_us, model_us;
+
+    t0 = now_us();
+    for (int i = 0; i < iterations; i++) old_path("true");
+    old_us = (now_us() - t0) / iterations;
+
+    t0 = now_us();
+    for (int i = 0; i < iterations; i++) spawn_path(true_argv);
+    spawn_us = (now_us() - t0) / iterations;
+
+    t0 = now_us();
+    for (int i = 0; i < iterations; i++) shell_path("true");
+    shell_us = (now_us() - t0) / iterations;
+
+    // Mesaj günlüğü ve geçmiş dosyası açılmasın; çocukların çıktısı /dev/null'a
+    setenv("TERMINAL_MSG_LOG", "", 1);
+    setenv("TERMINAL_HISTORY_FILE", "", 1);
+    fflush(stdout);
+    int saved_stdout = dup(STDOUT_FILENO), saved_stderr = dup(STDERR_FILENO);
+    int null_fd = open("/dev/null", O_WRONLY);
+    dup2(null_fd, STDOUT_FILENO);
+    dup2(null_fd, STDERR_FILENO);
+    Model *model = model_init("Bench");
+    t0 = now_us();
+    for (int i = 0; i < iterations; i++) model_execute_command(model, "true", NULL, NULL);
+    model_us = (now_us() - t0) / iterations;
+    model_destroy(model);
+    fflush(stdout);
+    dup2(saved_stdout, STDOUT_FILENO);
+    dup2(saved_stderr, STDERR_FILENO);
+    close(null_fd);
+    close(saved_stdout);
+    close(saved_stderr);
+
+    printf("heap: %zu MB, iterations: %d\n", heap_mb, iterations);
+    printf("fork+fork+sh -c : %8.1f us/command\n", old_us);
+    printf("posix_spawn argv: %8.1f us/command\n", spawn_us);
+    printf("posix_spawn sh  : %8.1f us/command\n", shell_us);
+    printf("model_execute   : %8.1f us/command\n", model_us);
+    bench_json("spawn", "fork_fork_sh", NULL, old_us, "us");
+    bench_json("spawn", "posix_spawn_argv", NULL, spawn_us, "us");
+    bench_json("spawn", "posix_spawn_sh", NULL, shell_us, "us");
+    bench_json("spawn", "model_execute", NULL, model_us, "us");
+    free(heap);
+    return 0;
+}
@@ -0,0 +1,125 @@
+// Çok kullanıcılı mesajlaşma yük testi: her kullanıcı ayrı bir süreçte mesaj
+// gönderirken diğerlerinin mesajlarını eventfd bildirimiyle okur; gönderimden
+// teslime kadar geçen süre kullanıcı sayısına göre raporlanır.
+// Kullanım: bench_users [en fazla kullanıcı] [kullanıcı başına mesaj]
+#define _GNU_SOURCE
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "bench.h"
+#include "model.h"
+
+#define MAX_SAMPLES (1 << 20)
+
+typedef struct {
+    _Atomic uint64_t count;
+    _Atomic uint64_t lost;
+    uint32_t samples[MAX_SAMPLES]; // Mikrosaniye
+} Results;
+
+typedef struct {
+    Model *model;
+    Results *results;
+    uint64_t expected;
+    uint64_t received;
+} Reader;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static void on_message(const MessageEntry *entry, void *data) {
+    Reader *reader = data;
+    unsigned long long sent;
+    if (strcmp(entry->sender, reader->model->username) == 0) return;
+    if (sscanf(entry->data, "t=%llu", &sent) != 1) return;
+    reader->received++;
+    uint64_t index = atomic_fetch_add(&reader->results->count, 1);
+    if (index < MAX_SAMPLES) reader->results->samples[index] = (uint32_t)((now_ns() - sent) / 1000);
+}
+
+static void *reader_main(void *arg) {
+    Reader *reader = arg;
+    struct pollfd pfd = { model_message_fd(reader->model), POLLIN, 0 };
+    uint64_t deadline = now_ns() + 10ull * 1000000000ull;
+    while (reader->received < reader->expected && now_ns() < deadline) {
+        if (poll(&pfd, 1, 100) > 0) model_message_ack(reader->model);
+        model_read_messages(reader->model, on_message, reader);
+    }
+    return NULL;
+}
+
+static void run_user(int id, int users, int messages, Results *results, _Atomic int *start) {
+    char username[MAX_USERNAME];
+    snprintf(username, sizeof(username), "User%d", id + 1);
+    Model *model = model_init(username);
+    Reader reader = { model, results, (uint64_t)(users - 1) * messages, 0 };
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, reader_main, &reader);
+    atomic_fetch_add(start, 1);
+    while (atomic_load(start) < users) sched_yield();
+
+    for (int i = 0; i < messages; i++) {
+        char text[64];
+        snprintf(text, sizeof(text), "t=%llu", (unsigned long long)now_ns());
+        model_send_message(model, text);
+        usleep(1000);
+    }
+    pthread_join(thread, NULL);
+    atomic_fetch_add(&results->lost, reader.expected - reader.received);
+    model_destroy(model);
+}
+
+static int compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+int main(int argc, char **argv) {
+    int max_users = argc > 1 ? atoi(argv[1]) : 32;
+    int messages = argc > 2 ? atoi(argv[2]) : 200;
+    size_t shared_size = sizeof(Results) + sizeof(_Atomic int);
+    Results *results = mmap(NULL, shared_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    _Atomic int *start = (_Atomic int *)(results + 1);
+
+    // Kalıcı günlüğü ve geçmişi kirletmesin, modelin printf'leri ölçümü boğmasın
+    setenv("TERMINAL_MSG_LOG", "", 1);
+    setenv("TERMINAL_HISTORY_FILE", "", 1);
+    if (!freopen("/dev/null", "w", stdout)) return 1;
+    fprintf(stderr, "%6s %10s %8s %8s %8s %8s %6s\n", "users", "delivered", "p50 us", "p90 us", "p99 us", "max us", "lost");
+
+    for (int users = 2; users <= max_users; users *= 2) {
+        atomic_store(&results->count, 0);
+        atomic_store(&results->lost, 0);
+        atomic_store(start, 0);
+        for (int i = 0; i < users; i++) {
+            if (fork() == 0) {
+                run_user(i, users, messages, results, start);
+                _exit(0);
+            }
+        }
+        while (wait(NULL) > 0) {}
+
+        uint64_t count = atomic_load(&results->count);
+        if (count > MAX_SAMPLES) count = MAX_SAMPLES;
+        qsort(results->samples, count, sizeof(uint32_t), compare_u32);
+        if (count == 0) continue;
+        fprintf(stderr, "%6d %10llu %8u %8u %8u %8u %6llu\n", users, (unsigned long long)count,
+                results->samples[count / 2], results->samples[count * 9 / 10], results->samples[count * 99 / 100],
+                results->samples[count - 1], (unsigned long long)atomic_load(&results->lost));
+        char params[32];
+        snprintf(params, sizeof(params), "users=%d", users);
+        bench_json("users", "delivery_p50", params, results->samples[count / 2], "us");
+        bench_json("users", "delivery_p99", params, results->samples[count * 99 / 100], "us");
+    }
+    return 0;
+}
@@ -0,0 +1,106 @@
+// Çıktı bölmesine ekleme maliyeti: view_append_output'a borudan okunmuş gibi
+// 4 KB'lık parçalar verilir (temizleme, stil etiketleri ve scrollback kırpma dahil),
+// ardından GTK'nın biriken yerleşim/çizim işini bitirmesi ayrıca ölçülür.
+// Ekran yoksa (DISPLAY/WAYLAND_DISPLAY) ölçüm atlanır.
+// Kullanım: bench_view [MB]
+#define _GNU_SOURCE
+#include <gtk/gtk.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "bench.h"
+#include "controller.h"
+
+#define CHUNK 4096
+
+static FILE *report; // Asıl stdout; fd 1 modelin printf'leri için /dev/null'a gider
+
+static double now_sec(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void on_command(const char *input, void *data) {}
+
+static void fill_lines(char *buf, size_t size, const char *const *lines, size_t count) {
+    size_t len = 0;
+    for (size_t i = 0; len < size; i++) {
+        const char *line = lines[i % count];
+        size_t n = strlen(line);
+        if (n > size - len) n = size - len;
+        memcpy(buf + len, line, n);
+        len += n;
+    }
+}
+
+static void drain(void) {
+    while (gtk_events_pending()) gtk_main_iteration();
+}
+
+static void run(View *view, const char *name, const char *buf, size_t size) {
+    double start = now_sec();
+    for (size_t off = 0; off < size; off += CHUNK) {
+        view_append_output(view, buf + off, size - off < CHUNK ? size - off : CHUNK);
+    }
+    double insert = now_sec() - start;
+    start = now_sec();
+    drain();
+    double layout = now_sec() - start;
+
+    double chunks = (double)((size + CHUNK - 1) / CHUNK);
+    fprintf(report, "%-12s insert %8.1f MB/s %8.1f us/chunk   layout %8.1f ms\n", name, size / insert / 1e6,
+            insert / chunks * 1e6, layout * 1e3);
+    char params[32];
+    snprintf(params, sizeof(params), "input=%s", name);
+    bench_json("view", "insert", params, size / insert / 1e6, "MB/s");
+    bench_json("view", "insert_chunk", params, insert / chunks * 1e6, "us");
+    bench_json("view", "layout", params, layout * 1e3, "ms");
+}
+
+int main(int argc, char **argv) {
+    size_t size = (size_t)(argc > 1 ? atol(argv[1]) : 16) << 20;
+    if (!gtk_init_check(NULL, NULL)) {
+        fprintf(stderr, "bench_view: no display, skipped\n");
+        return 0;
+    }
+    setenv("TERMINAL_MSG_LOG", "", 1);
+    setenv("TERMINAL_HISTORY_FILE", "", 1);
+    report = fdopen(dup(STDOUT_FILENO), "w");
+    if (!report || !freopen("/dev/null", "w", stdout)) return 1;
+
+    Controller ctrl = { .model = model_init("Bench") };
+    View *view = view_init(on_command, &ctrl);
+    drain();
+
+    static const char *const plain[] = {
+        "2024-05-01 12:00:01 INFO server started on port 8080\n",
+        "gcc -Wall -g -c model.c\n",
+        "    at com.example.Main.run(Main.java:42)\n",
+    };
+    static const char *const color[] = {
+        "\x1b[01;34mbench\x1b[0m  \x1b[01;32mterminal\x1b[0m  model.c  view.c\n",
+        "\x1b[01;31m\x1b[Kerror\x1b[m\x1b[K: expected ';' before '}' token\n",
+        "\x1b[38;5;208mwarning\x1b[0m: unused variable 'x'\n",
+    };
+    char *buf = malloc(size);
+
+    fill_lines(buf, size, plain, sizeof(plain) / sizeof(plain[0]));
+    run(view, "plain", buf, size);
+    fill_lines(buf, size, color, sizeof(color) / sizeof(color[0]));
+    run(view, "ansi", buf, size);
+
+    int commands = 10000;
+    double start = now_sec();
+    for (int i = 0; i < commands; i++) view_append_command(view, "ls -la /usr/include");
+    double command_us = (now_sec() - start) / commands * 1e6;
+    fprintf(report, "%-12s %8.2f us/command\n", "command", command_us);
+    bench_json("view", "append_command", NULL, command_us, "us");
+
+    free(buf);
+    view_destroy(view);
+    model_destroy(ctrl.model);
+    fclose(report);
+    return 0;
+}
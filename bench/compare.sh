@@ -0,0 +1,40 @@
+#!/bin/sh
+# İki "make bench" sonucunu karşılaştırır: bench/compare.sh eski.jsonl yeni.jsonl
+# Her ölçüm için eski/yeni değer ve değişim yazılır; birime göre (süre düşük,
+# verim yüksek iyidir) eşikten fazla kötüleşenler REGRESSION ile işaretlenir
+# ve çıkış kodu 1 olur. Eşik yüzde olarak BENCH_THRESHOLD ile değişir (varsayılan 10).
+if [ $# -ne 2 ]; then
+    echo "usage: $0 old.jsonl new.jsonl" >&2
+    exit 2
+fi
+
+awk -v threshold="${BENCH_THRESHOLD:-10}" '
+function field(line, name,    s) {
+    if (!match(line, "\"" name "\": (\"[^\"]*\"|[-+.0-9eE]+)")) return ""
+    s = substr(line, RSTART, RLENGTH)
+    sub(/^"[^"]*": /, "", s)
+    gsub(/"/, "", s)
+    return s
+}
+{
+    key = field($0, "bench") " " field($0, "metric")
+    params = field($0, "params")
+    if (params != "") key = key " [" params "]"
+}
+FNR == NR { old[key] = field($0, "value"); next }
+{
+    value = field($0, "value")
+    unit = field($0, "unit")
+    if (!(key in old) || old[key] == 0) {
+        printf "%-60s %12s %12g %s  (new)\n", key, "-", value, unit
+        next
+    }
+    change = (value - old[key]) / old[key] * 100
+    lower_is_better = (unit == "ns" || unit == "us" || unit == "ms" || unit == "s")
+    worse = lower_is_better ? change : -change
+    mark = ""
+    if (worse > threshold) { mark = "  REGRESSION"; failed = 1 }
+    printf "%-60s %12g %12g %s  %+6.1f%%%s\n", key, old[key], value, unit, change, mark
+}
+END { exit failed }
+' "$1" "$2"
@@ -0,0 +1,161 @@
+#include "compress.h"
+#include <stdint.h>
+#include <string.h>
+
+// Her dizi: belirteç (üst 4 bit düz bayt sayısı, alt 4 bit eşleşme uzunluğu - 4),
+// gerekirse 255'lik uzatma baytları, düz baytlar, 2 baytlık geri uzaklık ve
+// eşleşme uzatması. Son dizi yalnızca düz baytlardan oluşur.
+#define HASH_BITS 13
+#define MIN_MATCH 4
+#define MAX_OFFSET 65535
+#define LAST_LITERALS 5  // Son baytlar hep düz yazılır
+#define MATCH_LIMIT 12   // Girdinin sonuna bu kadar kala eşleşme aranmaz
+
+static uint32_t read32(const unsigned char *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t hash4(uint32_t v) {
+    return (v * 2654435761u) >> (32 - HASH_BITS);
+}
+
+// Eşleşmeyi 8 baytlık kelimelerle ileri uzatır
+static size_t match_length(const unsigned char *a, const unsigned char *b, const unsigned char *end) {
+    const unsigned char *start = b;
+    while (b + 8 <= end) {
+        uint64_t x, y;
+        memcpy(&x, a, 8);
+        memcpy(&y, b, 8);
+        if (x != y) return (size_t)(b - start) + (__builtin_ctzll(x ^ y) >> 3);
+        a += 8;
+        b += 8;
+    }
+    while (b < end && *a == *b) {
+        a++;
+        b++;
+    }
+    return (size_t)(b - start);
+}
+
+static unsigned char *write_length(unsigned char *op, size_t n) {
+    while (n >= 255) {
+        *op++ = 255;
+        n -= 255;
+    }
+    *op++ = (unsigned char)n;
+    return op;
+}
+
+// Bir diziyi yazar; match_len 0 ise son dizidir. Yer yetmezse NULL döner.
+static unsigned char *emit(unsigned char *op, unsigned char *op_end, const unsigned char *literals,
+                           size_t literal_len, size_t offset, size_t match_len) {
+    size_t need = 1 + literal_len / 255 + 1 + literal_len + 2 + match_len / 255 + 1;
+    if ((size_t)(op_end - op) < need) return NULL;
+
+    unsigned char *token = op++;
+    *token = (unsigned char)((literal_len < 15 ? literal_len : 15) << 4);
+    if (literal_len >= 15) op = write_length(op, literal_len - 15);
+    memcpy(op, literals, literal_len);
+    op += literal_len;
+    if (match_len == 0) return op;
+
+    *op++ = (unsigned char)(offset & 0xff);
+    *op++ = (unsigned char)(offset >> 8);
+    size_t code = match_len - MIN_MATCH;
+    *token |= (unsigned char)(code < 15 ? code : 15);
+    if (code >= 15) op = write_length(op, code - 15);
+    return op;
+}
+
+size_t lz_compress_bound(size_t len) {
+    return len + len / 255 + 16;
+}
+
+// Sıkıştırılmış boyutu döndürür; çıktı capacity'ye sığmazsa 0
+size_t lz_compress(const unsigned char *src, size_t len, unsigned char *dst, size_t capacity) {
+    uint32_t table[1 << HASH_BITS];
+    memset(table, 0, sizeof(table));
+    unsigned char *op = dst;
+    unsigned char *op_end = dst + capacity;
+    size_t ip = 0;
+    size_t anchor = 0;
+
+    if (len > MATCH_LIMIT) {
+        size_t limit = len - MATCH_LIMIT;
+        const unsigned char *match_end = src + len - LAST_LITERALS;
+        while (ip < limit) {
+            uint32_t seq = read32(src + ip);
+            uint32_t h = hash4(seq);
+            size_t ref = table[h];
+            table[h] = (uint32_t)ip;
+            if (ref >= ip || ip - ref > MAX_OFFSET || read32(src + ref) != seq) {
+                // Eşleşme bulamadıkça adımı büyüt (sıkışmayan veride hızlı geç)
+                ip += 1 + ((ip - anchor) >> 6);
+                continue;
+            }
+
+            size_t match_len = MIN_MATCH + match_length(src + ref + MIN_MATCH, src + ip + MIN_MATCH, match_end);
+            op = emit(op, op_end, src + anchor, ip - anchor, ip - ref, match_len);
+            if (!op) return 0;
+            ip += match_len;
+            anchor = ip;
+            if (ip < limit) table[hash4(read32(src + ip - 2))] = (uint32_t)(ip - 2);
+        }
+    }
+
+    op = emit(op, op_end, src + anchor, len - anchor, 0, 0);
+    return op ? (size_t)(op - dst) : 0;
+}
+
+static int read_length(const unsigned char *src, size_t len, size_t *ip, size_t *n) {
+    unsigned char b;
+    do {
+        if (*ip >= len) return -1;
+        b = src[(*ip)++];
+        *n += b;
+    } while (b == 255);
+    return 0;
+}
+
+// Çıktının tam out_len bayt olmasını bekler; bozuk girdide -1
+int lz_decompress(const unsigned char *src, size_t len, unsigned char *dst, size_t out_len) {
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < len) {
+        unsigned token = src[ip++];
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && read_length(src, len, &ip, &literal_len) == -1) return -1;
+        if (literal_len > len - ip || literal_len > out_len - op) return -1;
+        memcpy(dst + op, src + ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+        if (ip == len) break; // Son dizi
+
+        if (len - ip < 2) return -1;
+        size_t offset = src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > op) return -1;
+        size_t match_len = token & 15;
+        if (match_len == 15 && read_length(src, len, &ip, &match_len) == -1) return -1;
+        match_len += MIN_MATCH;
+        if (match_len > out_len - op) return -1;
+
+        unsigned char *out = dst + op;
+        const unsigned char *ref = out - offset;
+        if (offset >= match_len) {
+            memcpy(out, ref, match_len);
+        } else if (offset >= 8) {
+            // Örtüşen ama 8 bayttan uzak: kelime kelime kopyalamak güvenli
+            size_t i = 0;
+            for (; i + 8 <= match_len; i += 8) memcpy(out + i, ref + i, 8);
+            for (; i < match_len; i++) out[i] = ref[i];
+        } else {
+            for (size_t i = 0; i < match_len; i++) out[i] = ref[i];
+        }
+        op += match_len;
+    }
+    return op == out_len ? 0 : -1;
+}
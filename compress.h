@@ -0,0 +1,11 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stddef.h>
+
+// LZ4 blok biçimine benzer bağımsız sıkıştırıcı (64 KB pencere, dış bağımlılık yok)
+size_t lz_compress_bound(size_t len);
+size_t lz_compress(const unsigned char *src, size_t len, unsigned char *dst, size_t capacity);
+int lz_decompress(const unsigned char *src, size_t len, unsigned char *dst, size_t out_len);
+
+#endif
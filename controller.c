@@ -1,450 +1,1365 @@
+#define _GNU_SOURCE
 #include "controller.h"
+#include <glib-unix.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <stdio.h>
 #include <stdlib.h>
-#include <ctype.h>
 #include <fcntl.h>
+#include <errno.h>
+#include <signal.h>
+#include <wordexp.h>
+#include "log.h"
 
-// Komut ayrıştırma için yardımcı yapı
+// Bir komut satırının (&&, || ve ; ile bağlı boru hatları) yürütme durumu
 typedef struct {
-    char *args[10]; // Maksimum 10 argüman
-    int arg_count;
-    char *redirect_in;  // < için
-    char *redirect_out; // > için
-    int append;         // >> için (1 ise append, 0 ise overwrite)
-    char *pipe_next;    // | sonrası komut
-} ParsedCommand;
-
-void parse_command(const char *input, ParsedCommand *parsed) {
-    char temp[BUF_SIZE];
-    strncpy(temp, input, BUF_SIZE - 1);
-    temp[BUF_SIZE - 1] = '\0';
-
-    parsed->arg_count = 0;
-    parsed->redirect_in = NULL;
-    parsed->redirect_out = NULL;
-    parsed->append = 0;
-    parsed->pipe_next = NULL;
-
-    // Boru kontrolü
-    char *pipe_pos = strstr(temp, "|");
-    if (pipe_pos) {
-        *pipe_pos = '\0';
-        parsed->pipe_next = pipe_pos + 1;
-        while (isspace(*parsed->pipe_next)) parsed->pipe_next++;
-    }
-
-    // Yönlendirme kontrolü
-    char *redirect_out = strstr(temp, ">>");
-    if (redirect_out) {
-        *redirect_out = '\0';
-        parsed->redirect_out = redirect_out + 2;
-        parsed->append = 1;
-        while (isspace(*parsed->redirect_out)) parsed->redirect_out++;
-    } else {
-        redirect_out = strstr(temp, ">");
-        if (redirect_out) {
-            *redirect_out = '\0';
-            parsed->redirect_out = redirect_out + 1;
-            parsed->append = 0;
-            while (isspace(*parsed->redirect_out)) parsed->redirect_out++;
-        }
-    }
-
-    char *redirect_in = strstr(temp, "<");
-    if (redirect_in) {
-        *redirect_in = '\0';
-        parsed->redirect_in = redirect_in + 1;
-        while (isspace(*parsed->redirect_in)) parsed->redirect_in++;
-    }
-
-    // Argümanları ayrıştır
-    char *token = strtok(temp, " ");
-    int in_quotes = 0;
-    char quoted_arg[BUF_SIZE] = {0};
-    int quoted_pos = 0;
-
-    while (token && parsed->arg_count < 10) {
-        if (token[0] == '"') {
-            in_quotes = 1;
-            quoted_pos = 0;
-            strncpy(quoted_arg, token + 1, BUF_SIZE - 1);
-            quoted_pos = strlen(token) - 1;
-        } else if (in_quotes) {
-            if (token[strlen(token) - 1] == '"') {
-                in_quotes = 0;
-                token[strlen(token) - 1] = '\0';
-                strncat(quoted_arg, " ", BUF_SIZE - quoted_pos - 1);
-                quoted_pos++;
-                strncat(quoted_arg, token, BUF_SIZE - quoted_pos - 1);
-                parsed->args[parsed->arg_count] = strdup(quoted_arg);
-                parsed->arg_count++;
+    Controller *ctrl;
+    Parser *parser;     // Satırın AST'si bu arenada yaşar
+    CommandLine *line;
+    Pipeline *next;     // Sıradaki boru hattı
+    int last_status;    // $? karşılığı
+    struct CommandData *command; // Çalışan boru hattı (NULL = yok)
+    struct Job *job;    // Arka plan işinin satırıysa iş
+} LineRun;
+
+// Çıktı kare başına (~16 ms) bir kez görünüme yazılır. Birikim OUTPUT_HIGH_WATER'ı
+// aşınca borular okunmaz, çocuklar yazarken bloklanır; OUTPUT_LOW_WATER'ın altına
+// inince okuma sürer. Bir karede en fazla OUTPUT_FRAME_BYTES yazılır.
+#define OUTPUT_FRAME_MS 16
+#define OUTPUT_FRAME_BYTES (256 * 1024)
+#define OUTPUT_HIGH_WATER (1024 * 1024)
+#define OUTPUT_LOW_WATER (OUTPUT_HIGH_WATER / 4)
+
+// Asenkron komut çalıştırma için yardımcı yapı (tek komut ya da çok aşamalı boru hattı)
+typedef struct CommandData {
+    Controller *ctrl;
+    LineRun *run;
+    char output[BUF_SIZE];
+    const char *redirect_out; // Son aşamanın yönlendirildiği dosya (varsa, arenada)
+    pid_t *pids;        // Her aşamanın PID'i
+    int *statuses;      // Her aşamanın waitpid durumu
+    int *pidfds;        // Çıkışı izlenen pidfd (-1: GLib'in çocuk izleyicisi, -2: toplandı)
+    guint *exit_sources; // Aşamanın pidfd ya da çocuk izleyicisi GSource'u (0: toplandı)
+    int stage_count;
+    int exited_count;   // Toplanan aşama sayısı
+    int spawn_failed;   // Bir aşama başlatılamadıysa 127
+    guint fd_source;    // Çıktı borusunu izleyen GSource
+    int read_fd;        // Çıktı borusunun okuma ucu
+    struct CommandData *next_paused;
+    size_t total;       // Okunan toplam bayt
+    int output_done;    // Boruda EOF görüldü mü
+} CommandData;
+
+// Biten bir komutun çıktısı akışta mark baytında bitiyor; oraya kadar
+// görünüme verilince aşamaları "gösterildi" olarak damgalanır
+typedef struct RenderWait {
+    struct RenderWait *next;
+    uint64_t mark;
+    int count;
+    pid_t pids[];
+} RenderWait;
+
+static void run_continue(LineRun *run);
+static void job_finished(Controller *ctrl, struct Job *job, int status);
+static gboolean on_command_output(gint fd, GIOCondition condition, gpointer user_data);
+
+static void render_done(Controller *ctrl, const pid_t *pids, int count) {
+    for (int i = 0; i < count; i++) {
+        model_process_event(ctrl->model, pids[i], PROCESS_RENDERED);
+        model_process_finished(ctrl->model, pids[i]);
+    }
+}
+
+static void render_wait(Controller *ctrl, const pid_t *pids, int count) {
+    if (ctrl->pending->len == 0) {
+        render_done(ctrl, pids, count);
+        return;
+    }
+    RenderWait *wait = malloc(sizeof(RenderWait) + sizeof(pid_t) * count);
+    wait->next = NULL;
+    wait->mark = ctrl->flushed + ctrl->pending->len;
+    wait->count = count;
+    memcpy(wait->pids, pids, sizeof(pid_t) * count);
+    if (ctrl->render_tail) ctrl->render_tail->next = wait;
+    else ctrl->render_head = wait;
+    ctrl->render_tail = wait;
+}
+
+static void render_release(Controller *ctrl) {
+    while (ctrl->render_head && ctrl->render_head->mark <= ctrl->flushed) {
+        RenderWait *wait = ctrl->render_head;
+        ctrl->render_head = wait->next;
+        if (!ctrl->render_head) ctrl->render_tail = NULL;
+        render_done(ctrl, wait->pids, wait->count);
+        free(wait);
+    }
+}
+
+// Bekleyen çıktının bir karelik kısmını görünüme yazar; mümkünse satır sonunda keser
+static void output_flush_frame(Controller *ctrl) {
+    GString *pending = ctrl->pending;
+    size_t len = pending->len;
+    if (len > OUTPUT_FRAME_BYTES) {
+        const char *newline = memrchr(pending->str, '\n', OUTPUT_FRAME_BYTES);
+        len = newline ? (size_t)(newline - pending->str) + 1 : OUTPUT_FRAME_BYTES;
+    }
+    view_append_output(ctrl->view, pending->str, len);
+    g_string_erase(pending, 0, (gssize)len);
+    ctrl->flushed += len;
+    render_release(ctrl);
+
+    // Birikim eridiyse duraklatılan boruları yeniden izle
+    if (pending->len >= OUTPUT_LOW_WATER) return;
+    while (ctrl->paused) {
+        CommandData *data = ctrl->paused;
+        ctrl->paused = data->next_paused;
+        data->next_paused = NULL;
+        data->fd_source = g_unix_fd_add(data->read_fd, G_IO_IN | G_IO_HUP | G_IO_ERR, on_command_output, data);
+    }
+}
+
+static gboolean on_output_frame(gpointer user_data) {
+    Controller *ctrl = (Controller *)user_data;
+    output_flush_frame(ctrl);
+    if (ctrl->pending->len > 0) return G_SOURCE_CONTINUE;
+    ctrl->flush_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static void output_push(Controller *ctrl, const char *text, size_t len) {
+    if (len == 0) return;
+    g_string_append_len(ctrl->pending, text, (gssize)len);
+    if (!ctrl->flush_source) ctrl->flush_source = g_timeout_add(OUTPUT_FRAME_MS, on_output_frame, ctrl);
+}
+
+// Sıra bozulmasın diye komut satırı yazılmadan önce bekleyen her şey boşaltılır
+static void output_flush_all(Controller *ctrl) {
+    while (ctrl->pending->len > 0) output_flush_frame(ctrl);
+    if (ctrl->flush_source) g_source_remove(ctrl->flush_source);
+    ctrl->flush_source = 0;
+}
+
+static void append_output(Controller *ctrl, const char *text) {
+    output_push(ctrl, text, strlen(text));
+}
+
+// waitpid durumunu shell çıkış koduna çevir
+static int exit_code(int status) {
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return WEXITSTATUS(status);
+}
+
+// Aşamanın stdout'u bir dosyaya gidiyorsa o dosya (son yönlendirme geçerli)
+static const Redirect *stdout_redirect(const Stage *stage) {
+    const Redirect *found = NULL;
+    for (const Redirect *r = stage->redirects; r; r = r->next) {
+        if (r->fd == STDOUT_FILENO) found = (r->type == REDIRECT_OUT || r->type == REDIRECT_APPEND) ? r : NULL;
+    }
+    return found;
+}
+
+static CommandData *command_data_new(Controller *ctrl, LineRun *run) {
+    CommandData *data = calloc(1, sizeof(CommandData));
+    data->ctrl = ctrl;
+    data->run = run;
+    return data;
+}
+
+static void command_data_free(CommandData *data) {
+    free(data->pids);
+    free(data->statuses);
+    free(data->pidfds);
+    free(data->exit_sources);
+    free(data);
+}
+
+// Yarıda bırakılan komutun ana döngü kaynaklarını kaldırır; geri çağrılar
+// serbest kalan veriye ulaşmasın
+static void command_data_unwatch(CommandData *data) {
+    Controller *ctrl = data->ctrl;
+    if (data->fd_source) g_source_remove(data->fd_source);
+    data->fd_source = 0;
+    if (!data->output_done) close(data->read_fd);
+    for (CommandData **paused = &ctrl->paused; *paused; paused = &(*paused)->next_paused) {
+        if (*paused == data) {
+            *paused = data->next_paused;
+            break;
+        }
+    }
+    for (int i = 0; i < data->stage_count; i++) {
+        if (data->exit_sources[i]) g_source_remove(data->exit_sources[i]);
+        if (data->pidfds[i] >= 0) close(data->pidfds[i]);
+    }
+}
+
+static void command_data_add_stage(CommandData *data, pid_t pid) {
+    data->pids = realloc(data->pids, sizeof(pid_t) * (data->stage_count + 1));
+    data->statuses = realloc(data->statuses, sizeof(int) * (data->stage_count + 1));
+    data->pidfds = realloc(data->pidfds, sizeof(int) * (data->stage_count + 1));
+    data->exit_sources = realloc(data->exit_sources, sizeof(guint) * (data->stage_count + 1));
+    data->pids[data->stage_count] = pid;
+    data->statuses[data->stage_count] = 0;
+    data->pidfds[data->stage_count] = -1;
+    data->exit_sources[data->stage_count] = 0;
+    data->stage_count++;
+}
+
+// Hem EOF hem de tüm aşamaların çıkışı görüldüğünde komutu sonlandır
+static void command_finished(CommandData *data) {
+    Controller *ctrl = data->ctrl;
+    for (int i = 0; i < data->stage_count; i++) {
+        LOG_DEBUG(LOG_SPAWN, "Child process %d exited with status %d", data->pids[i],
+                  WEXITSTATUS(data->statuses[i]));
+    }
+    // Aşağıdaki durum satırlarından önce: yalnızca komutun kendi çıktısı sayılır
+    render_wait(ctrl, data->pids, data->stage_count);
+
+    // Yönlendirme varsa mesaj göster
+    if (data->redirect_out) {
+        snprintf(data->output, BUF_SIZE, "Output redirected to %s\n", data->redirect_out);
+        append_output(ctrl, data->output);
+    } else if (data->total == 0 && !data->spawn_failed) {
+        append_output(ctrl, data->stage_count > 1 ? "No output from pipe\n" : "Command executed, but no output\n");
+    }
+
+    // Boru hattında her aşamanın çıkış durumunu bildir
+    if (data->stage_count > 1) {
+        size_t off = (size_t)snprintf(data->output, BUF_SIZE, "Pipeline exit status:");
+        for (int i = 0; i < data->stage_count && off < BUF_SIZE; i++) {
+            int st = data->statuses[i];
+            off += (size_t)snprintf(data->output + off, BUF_SIZE - off, WIFSIGNALED(st) ? " sig%d" : " %d",
+                                    WIFSIGNALED(st) ? WTERMSIG(st) : WEXITSTATUS(st));
+        }
+        if (off < BUF_SIZE - 1) strcat(data->output, "\n");
+        append_output(ctrl, data->output);
+    }
+
+    // Satırın geri kalanına son aşamanın durumuyla devam et
+    LineRun *run = data->run;
+    run->last_status = data->spawn_failed ? data->spawn_failed : exit_code(data->statuses[data->stage_count - 1]);
+    run->command = NULL;
+    command_data_free(data);
+    run_continue(run);
+}
+
+// Boru okunabilir olduğunda ana döngüden çağrılır; asla bloklamaz
+static gboolean on_command_output(gint fd, GIOCondition condition, gpointer user_data) {
+    CommandData *data = (CommandData *)user_data;
+    char buffer[BUF_SIZE];
+
+    // Tek uyanışta sınırlı sayıda okuma yap, böylece akan çıktı ana döngüyü aç bırakmaz
+    for (int i = 0; i < 16; i++) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n > 0) {
+            Controller *ctrl = data->ctrl;
+            if (data->total == 0) {
+                for (int s = 0; s < data->stage_count; s++) {
+                    model_process_event(ctrl->model, data->pids[s], PROCESS_FIRST_BYTE);
+                }
+            }
+            output_push(ctrl, buffer, (size_t)n);
+            data->total += (size_t)n;
+            if (ctrl->pending->len < OUTPUT_HIGH_WATER) continue;
+            // Görünüm yetişemiyor: boruyu bırak, kare zamanlayıcısı geri açar
+            data->fd_source = 0;
+            data->next_paused = ctrl->paused;
+            ctrl->paused = data;
+            return G_SOURCE_REMOVE;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) return G_SOURCE_CONTINUE;
+        if (n < 0) perror("read failed");
+
+        // EOF (veya hata): boruyu kapat
+        close(fd);
+        data->fd_source = 0;
+        data->output_done = 1;
+        for (int s = 0; s < data->stage_count; s++) {
+            model_process_event(data->ctrl->model, data->pids[s], PROCESS_EOF);
+        }
+        if (data->exited_count == data->stage_count) command_finished(data);
+        return G_SOURCE_REMOVE;
+    }
+    return G_SOURCE_CONTINUE;
+}
+
+static void stage_exited(CommandData *data, pid_t pid, int status, const struct rusage *usage) {
+    model_process_exited(data->ctrl->model, pid, status, usage);
+    for (int i = 0; i < data->stage_count; i++) {
+        if (data->pids[i] == pid) {
+            data->statuses[i] = status;
+            data->pidfds[i] = -2;
+            data->exit_sources[i] = 0; // Geri çağrı dönünce GLib kaldırır
+            break;
+        }
+    }
+    data->exited_count++;
+    if (data->output_done && data->exited_count == data->stage_count) command_finished(data);
+}
+
+// pidfd okunabilir: aşama çıktı, wait4 ile CPU süresi ve en yüksek RSS'le birlikte topla
+static gboolean on_stage_pidfd(gint fd, GIOCondition condition, gpointer user_data) {
+    CommandData *data = (CommandData *)user_data;
+    int stage = 0;
+    while (stage < data->stage_count && data->pidfds[stage] != fd) stage++;
+    if (stage == data->stage_count) return G_SOURCE_REMOVE;
+
+    pid_t pid = data->pids[stage];
+    int status = 0;
+    struct rusage usage;
+    pid_t reaped = wait4(pid, &status, WNOHANG, &usage);
+    if (reaped == 0 || (reaped < 0 && errno == EINTR)) return G_SOURCE_CONTINUE;
+    close(fd);
+    stage_exited(data, pid, status, reaped == pid ? &usage : NULL);
+    return G_SOURCE_REMOVE;
+}
+
+// pidfd yoksa (Linux 5.3 öncesi) GLib toplar; kaynak kullanımı bilinmez
+static void on_command_exit(GPid pid, gint status, gpointer user_data) {
+    g_spawn_close_pid(pid);
+    stage_exited((CommandData *)user_data, pid, status, NULL);
+}
+
+// Çıktısı izlenmeyen süreçler (nano) için: yalnızca topla, zombi bırakma
+static void on_detached_exit(GPid pid, gint status, gpointer user_data) {
+    Controller *ctrl = (Controller *)user_data;
+    g_spawn_close_pid(pid);
+    model_process_exited(ctrl->model, pid, status, NULL);
+    model_process_finished(ctrl->model, pid);
+}
+
+// Çıktı borusunu ve tüm aşamaları ana döngüye bağla; buradan sonra hiçbir şey bloklamaz
+static void command_data_watch(CommandData *data, int read_fd) {
+    fcntl(read_fd, F_SETFL, fcntl(read_fd, F_GETFL) | O_NONBLOCK);
+    data->read_fd = read_fd;
+    data->fd_source = g_unix_fd_add(read_fd, G_IO_IN | G_IO_HUP | G_IO_ERR, on_command_output, data);
+    for (int i = 0; i < data->stage_count; i++) {
+        int pidfd = (int)syscall(SYS_pidfd_open, data->pids[i], 0);
+        if (pidfd >= 0) {
+            data->pidfds[i] = pidfd;
+            data->exit_sources[i] = g_unix_fd_add(pidfd, G_IO_IN, on_stage_pidfd, data);
+        } else {
+            data->exit_sources[i] = g_child_watch_add(data->pids[i], on_command_exit, data);
+        }
+    }
+}
+
+// Boru hattını başlatır: aşamalar birbirine bağlanır, son aşamanın çıktısı
+// çalışırken boşaltılır, böylece pipe kapasitesini aşan çıktı kilitlenmeye yol açmaz.
+// input_fd >= 0 ise ilk aşama yerleşik komut olarak zaten çalıştı: çıktısı bu
+// dosyadadır ve ikinci aşamanın girişi olur (tanımlayıcı burada kapatılır).
+// Hiçbir aşama başlatılamazsa -1 döner ve run->last_status ayarlanır.
+static int start_pipeline(Controller *ctrl, LineRun *run, Pipeline *pipeline, int input_fd) {
+    static char *const true_argv[] = { "true", NULL };
+    char output[BUF_SIZE];
+    int pipefd[2] = {-1, -1};
+    int prev_read_fd = input_fd;
+    int output_pipefd[2] = {-1, -1}; // Son çıktıyı almak için ayrı bir boru
+
+    // Son çıktıyı almak için bir boru oluştur
+    if (pipe2(output_pipefd, O_CLOEXEC) == -1) {
+        append_output(ctrl, "Error: Failed to create output pipe\n");
+        if (input_fd >= 0) close(input_fd);
+        run->last_status = 1;
+        return -1;
+    }
+
+    CommandData *data = command_data_new(ctrl, run);
+    for (Stage *stage = input_fd >= 0 ? pipeline->stages->next : pipeline->stages; stage; stage = stage->next) {
+        // Yeni bir boru oluştur (son komut hariç)
+        if (stage->next && pipe2(pipefd, O_CLOEXEC) == -1) {
+            append_output(ctrl, "Error: Failed to create pipe\n");
+            data->spawn_failed = 1;
+            break;
+        }
+
+        // Aşamayı doğrudan exec et; sh yalnızca genişletme gerekiyorsa kullanılır
+        SpawnRequest req;
+        const Redirect *failed_redirect = NULL;
+        spawn_request_init(&req);
+        req.failed_redirect = &failed_redirect;
+        req.stdin_fd = prev_read_fd; // Giriş yönlendirmesi
+        req.stdout_fd = stage->next ? pipefd[1] : output_pipefd[1];
+        req.stderr_fd = output_pipefd[1]; // Hatalar da çıktı paneline gider
+        if (stage->needs_shell) {
+            req.shell_command = stage->text;
+        } else {
+            req.argv = stage->argc > 0 ? stage->argv : true_argv;
+            req.redirects = stage->redirects;
+        }
+
+        LOG_DEBUG(LOG_SPAWN, "Executing pipeline stage: %s", stage->text);
+        pid_t pid = model_spawn_command(ctrl->model, stage->text, &req);
+        int err = errno;
+        if (pid < 0) {
+            if (failed_redirect) {
+                // Shell gibi: komut hiç çalışmaz, durum 1
+                snprintf(output, sizeof(output), "%s: %s\n", failed_redirect->target, strerror(err));
+            } else if (err == ENOENT && req.argv) {
+                snprintf(output, sizeof(output), "%s: command not found\n", req.argv[0]);
+            } else if (err == EAGAIN) {
+                snprintf(output, sizeof(output), "Error: Process table full (%d processes)\n",
+                         ctrl->model->process_capacity);
             } else {
-                strncat(quoted_arg, " ", BUF_SIZE - quoted_pos - 1);
-                quoted_pos++;
-                strncat(quoted_arg, token, BUF_SIZE - quoted_pos - 1);
-                quoted_pos += strlen(token);
+                snprintf(output, sizeof(output), "Error: Failed to execute '%s': %s\n", stage->text, strerror(err));
+            }
+            append_output(ctrl, output);
+            if (stage->next) {
+                close(pipefd[0]);
+                close(pipefd[1]);
             }
+            data->spawn_failed = failed_redirect ? 1 : (err == ENOENT) ? 127 : 126;
+            break;
+        }
+
+        // Ana süreç: Boruyu kapat ve bir sonraki komuta geç
+        command_data_add_stage(data, pid);
+        if (prev_read_fd != -1) {
+            close(prev_read_fd);
+            prev_read_fd = -1;
+        }
+        if (stage->next) {
+            close(pipefd[1]); // Yazma ucunu kapat
+            prev_read_fd = pipefd[0]; // Okuma ucunu bir sonraki komut için sakla
         } else {
-            parsed->args[parsed->arg_count] = strdup(token);
-            parsed->arg_count++;
+            // sh'ye giden aşamanın yönlendirmesi de ayrıştırılmıştır; hedef açılmamış
+            // metin olarak gösterilir ("$HOME/out" gibi)
+            const Redirect *r = stdout_redirect(stage);
+            if (r) data->redirect_out = r->target;
         }
-        token = strtok(NULL, " ");
     }
 
-    if (in_quotes) {
-        // Tırnak kapanmadı, hata
-        parsed->args[0] = strdup("echo");
-        parsed->args[1] = strdup("Error: Unclosed quotes");
-        parsed->arg_count = 2;
+    // Yarıda kalan bir hattın okuma ucu: önceki aşama EOF/SIGPIPE görsün
+    if (prev_read_fd != -1) close(prev_read_fd);
+    close(output_pipefd[1]); // Yazma ucunu kapat
+
+    if (data->stage_count == 0) {
+        close(output_pipefd[0]);
+        run->last_status = data->spawn_failed;
+        command_data_free(data);
+        return -1;
     }
 
-    parsed->args[parsed->arg_count] = NULL; // Argüman listesini sonlandır
+    command_data_watch(data, output_pipefd[0]);
+    run->command = data;
+    return 0;
+}
+
+static LineRun *run_new(Controller *ctrl, Parser *parser, CommandLine *line) {
+    LineRun *run = calloc(1, sizeof(LineRun));
+    run->ctrl = ctrl;
+    run->parser = parser;
+    run->line = line;
+    run->next = line ? line->pipelines : NULL;
+    return run;
 }
 
-void free_parsed_command(ParsedCommand *parsed) {
-    for (int i = 0; i < parsed->arg_count; i++) {
-        if (parsed->args[i]) {
-            free(parsed->args[i]);
-            parsed->args[i] = NULL; // Çift serbest bırakmayı önlemek için NULL yap
+// Satırın arenasını bir sonraki komut için sakla
+static void run_free(LineRun *run) {
+    Controller *ctrl = run->ctrl;
+    parser_reset(run->parser);
+    if (!ctrl->spare_parser) {
+        ctrl->spare_parser = run->parser;
+    } else {
+        parser_free(run->parser);
+    }
+    free(run);
+}
+
+// & ile başlatılan arka plan işi: && / || ile bağlı boru hatları kendi
+// satırında çalışır. Başlatan satırın arenası onunla birlikte gittiği için
+// işin metni kendi ayrıştırıcısında yeniden ayrıştırılır.
+typedef struct Job {
+    int id;
+    uint64_t order;     // Sıradakiler geliş sırasıyla başlar
+    char *text;
+    LineRun *run;
+    int started;        // 0 ise eşzamanlılık sınırı yüzünden sırada
+    int announced;      // "[n] pid" yazıldı mı
+    LineRun *waiter;    // fg ile bekleyen satır
+} Job;
+
+// Biten işte komut kalmaz; kapanışta süren işin boru hattı kaynaklarıyla bırakılır
+static void job_free(Job *job) {
+    if (job->run && job->run->command) {
+        command_data_unwatch(job->run->command);
+        command_data_free(job->run->command);
+    }
+    if (job->run) run_free(job->run);
+    g_free(job->text);
+    free(job);
+}
+
+// İşi tablodan çıkarır; numarası bir sonraki işe verilebilir
+static void job_remove(Controller *ctrl, Job *job) {
+    ctrl->jobs[job->id - 1] = NULL;
+    ctrl->job_count--;
+    if (job->started) ctrl->jobs_running--;
+    job_free(job);
+}
+
+static void job_end(Controller *ctrl, Job *job, int status) {
+    char state[64];
+    char output[BUF_SIZE];
+    LOG_DEBUG(LOG_CONTROLLER, "Job %d ended with status %d: %s", job->id, status, job->text);
+    if (status > 128 && status - 128 < NSIG) snprintf(state, sizeof(state), "%s", strsignal(status - 128));
+    else if (status) snprintf(state, sizeof(state), "Exit %d", status);
+    else snprintf(state, sizeof(state), "Done");
+    snprintf(output, sizeof(output), "[%d] %-12s %s\n", job->id, state, job->text);
+    append_output(ctrl, output);
+    job_remove(ctrl, job);
+}
+
+// İlk süreç başlayınca numarası ve PID'i bir kez yazılır
+static void job_announce(Job *job) {
+    char output[64];
+    CommandData *data = job->run->command;
+    if (job->announced || !data) return;
+    job->announced = 1;
+    snprintf(output, sizeof(output), "[%d] %d\n", job->id, (int)data->pids[data->stage_count - 1]);
+    append_output(job->run->ctrl, output);
+}
+
+// Yalnızca yerleşik komutlardan oluşan iş burada bitebilir; dönüşte job geçersiz olabilir
+static void job_start(Controller *ctrl, Job *job) {
+    job->started = 1;
+    ctrl->jobs_running++;
+    run_continue(job->run);
+}
+
+// Sınırın altında kaldıkça sıradaki en eski işi başlat
+static void job_schedule(Controller *ctrl) {
+    while (ctrl->jobs_running < ctrl->job_limit) {
+        Job *next = NULL;
+        for (int i = 0; i < MAX_JOBS; i++) {
+            Job *job = ctrl->jobs[i];
+            if (job && !job->started && (!next || job->order < next->order)) next = job;
         }
+        if (!next) return;
+        job_start(ctrl, next);
     }
-    parsed->arg_count = 0;
-    parsed->redirect_in = NULL;
-    parsed->redirect_out = NULL;
-    parsed->append = 0;
-    parsed->pipe_next = NULL;
 }
 
-// Asenkron komut çalıştırma için yardımcı yapı
-typedef struct {
-    Controller *ctrl;
-    char command[BUF_SIZE];
+// İşin satırı bitti: bildir, sıradakini başlat, fg ile bekleyen satır
+// varsa işin durumuyla devam ettir (o satır bitince kendisi bildirir)
+static void job_finished(Controller *ctrl, Job *job, int status) {
+    LineRun *waiter = job->waiter;
+    job_end(ctrl, job, status);
+    job_schedule(ctrl);
+    if (waiter) {
+        waiter->last_status = status;
+        run_continue(waiter);
+    } else if (ctrl->running == 0 && ctrl->job_count == 0) {
+        // Görünüm girdisi bitmişse son işi bekliyordur (headless EOF'ta çıkar)
+        view_command_done(ctrl->view);
+    }
+}
+
+// first..last (son boru hattı & ile biten && / || listesi) iş tablosuna
+// eklenir; eşzamanlı iş sınırı doluysa sırada bekler
+static int job_add(Controller *ctrl, const Pipeline *first, const Pipeline *last) {
     char output[BUF_SIZE];
-    int pipefd[2];
-    pid_t pid;
-    ParsedCommand parsed; // Yönlendirme bilgilerini saklamak için
-} CommandData;
+    int slot = 0;
+    while (slot < MAX_JOBS && ctrl->jobs[slot]) slot++;
+    if (slot == MAX_JOBS) {
+        snprintf(output, sizeof(output), "Error: Too many jobs (%d)\n", MAX_JOBS);
+        append_output(ctrl, output);
+        return 1;
+    }
 
-// Komut tamamlandığında çağrılacak geri çağrı fonksiyonu
-static gboolean command_finished(gpointer user_data) {
-    CommandData *data = (CommandData *)user_data;
-    Controller *ctrl = data->ctrl;
+    GString *text = g_string_new(NULL);
+    for (const Pipeline *p = first;; p = p->next) {
+        if (p != first) g_string_append(text, p->condition == RUN_IF_SUCCESS ? " && " : " || ");
+        g_string_append(text, p->text);
+        if (p == last) break;
+    }
+    Job *job = calloc(1, sizeof(Job));
+    Parser *parser = parser_new();
+    CommandLine *line = parser ? parser_parse(parser, text->str) : NULL;
+    if (!job || !line || line->pipeline_count == 0) {
+        free(job);
+        parser_free(parser);
+        g_string_free(text, TRUE);
+        append_output(ctrl, "Error: Out of memory\n");
+        return 1;
+    }
+    job->id = slot + 1;
+    job->order = ctrl->job_order++;
+    job->text = g_string_free(text, FALSE);
+    job->run = run_new(ctrl, parser, line);
+    job->run->job = job;
+    ctrl->jobs[slot] = job;
+    ctrl->job_count++;
 
-    // Borudan çıktıyı oku
-    close(data->pipefd[1]); // Yazma ucunu kapat
-    char buffer[BUF_SIZE] = {0};
-    ssize_t n = read(data->pipefd[0], buffer, BUF_SIZE - 1);
-    if (n > 0) {
-        buffer[n] = '\0';
-        strncpy(data->output, buffer, BUF_SIZE - 1);
-        fprintf(stderr, "Command output: %s\n", data->output); // Debug için stderr'a yaz
+    if (ctrl->jobs_running < ctrl->job_limit) {
+        job_start(ctrl, job);
     } else {
-        data->output[0] = '\0';
-        fprintf(stderr, "No output received\n"); // Debug için stderr'a yaz
+        snprintf(output, sizeof(output), "[%d] queued (%d running)\n", job->id, ctrl->jobs_running);
+        append_output(ctrl, output);
     }
-    close(data->pipefd[0]);
+    return 0;
+}
+
+// %n, n ya da verilmezse en son eklenen iş
+static Job *job_find(Controller *ctrl, const char *spec) {
+    if (!spec || strcmp(spec, "%") == 0 || strcmp(spec, "%+") == 0) {
+        Job *newest = NULL;
+        for (int i = 0; i < MAX_JOBS; i++) {
+            Job *job = ctrl->jobs[i];
+            if (job && (!newest || job->order > newest->order)) newest = job;
+        }
+        return newest;
+    }
+    if (*spec == '%') spec++;
+    char *end;
+    long id = strtol(spec, &end, 10);
+    if (end == spec || *end || id < 1 || id > MAX_JOBS) return NULL;
+    return ctrl->jobs[id - 1];
+}
 
-    // Sürecin tamamlanmasını bekle
-    int status;
-    waitpid(data->pid, &status, 0);
-    fprintf(stderr, "Child process %d exited with status %d\n", data->pid, WEXITSTATUS(status)); // Debug için stderr'a yaz
+// Çalışan boru hattının henüz toplanmamış aşamalarına sinyal gönderir (pidfd
+// varsa PID başka bir sürece geçmiş olamaz). Sıradaki iş hiç başlamadan düşer.
+static void job_signal(Controller *ctrl, Job *job, int sig) {
+    if (!job->started) {
+        if (sig) job_end(ctrl, job, 128 + sig);
+        return;
+    }
+    CommandData *data = job->run->command;
+    if (!data) return;
+    for (int i = 0; i < data->stage_count; i++) {
+        if (data->pidfds[i] >= 0) syscall(SYS_pidfd_send_signal, data->pidfds[i], sig, NULL, 0);
+        else if (data->pidfds[i] == -1) kill(data->pids[i], sig);
+    }
+}
 
-    // Yönlendirme varsa mesaj göster, yoksa çıktıyı göster
-    if (data->parsed.redirect_out) {
-        snprintf(data->output, BUF_SIZE, "Output redirected to %s\n", data->parsed.redirect_out);
+// fg [%n]: satır iş bitene kadar bekler; sıradaki iş sınırı beklemeden başlar.
+// Satır beklemeye geçtiyse 0 döner.
+static int job_foreground(Controller *ctrl, LineRun *run, Stage *stage) {
+    char output[BUF_SIZE];
+    const char *spec = stage->argc > 1 ? stage->argv[1] : NULL;
+    Job *job = job_find(ctrl, spec);
+    if (!job || job->waiter || job->run == run) {
+        snprintf(output, sizeof(output), job ? "fg: job %s already in foreground\n" : "fg: %s: no such job\n",
+                 spec ? spec : "current");
+        append_output(ctrl, output);
+        run->last_status = 1;
+        return -1;
     }
-    if (strlen(data->output) > 0) {
-        view_update_output(ctrl->view, data->output);
+    snprintf(output, sizeof(output), "%s\n", job->text);
+    append_output(ctrl, output);
+    job->waiter = run;
+    if (!job->started) job_start(ctrl, job);
+    return 0;
+}
+
+// Süreç oluşturmadan çalışan yerleşik komutlar. Çıktı ya bellek akışına
+// (çıktı paneli) ya da > / >> ile açılan dosyaya yazılır.
+#define BUILTIN_EXPAND 1 // ~, $VAR ve glob süreç içinde genişletilir; etkisi sh'de kaybolmasın
+#define BUILTIN_PIPE 2   // Yalnızca çıktı üretir: boru hattının ilk aşaması olabilir
+
+typedef struct {
+    const char *name;
+    int (*run)(Controller *ctrl, Stage *stage, FILE *out, FILE *err);
+    int flags;
+} Builtin;
+
+#define MAX_PATH_LEN 1024
+
+static int builtin_cd(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    (void)ctrl;
+    if (stage->argc < 2) {
+        fprintf(err, "cd: missing directory argument\n");
+        return 1;
+    }
+    const char *arg = stage->argv[1];
+    if (chdir(arg) != 0) {
+        fprintf(err, "cd: failed to change directory to '%.*s'\n", MAX_PATH_LEN, arg);
+        return 1;
+    }
+    char cwd[BUF_SIZE];
+    if (getcwd(cwd, sizeof(cwd)) != NULL) {
+        fprintf(out, "Changed directory to: %.*s\n", MAX_PATH_LEN, cwd);
     } else {
-        view_update_output(ctrl->view, "Command executed, but no output\n");
+        fprintf(err, "Changed directory, but failed to get current directory\n");
     }
+    return 0;
+}
 
-    // Belleği serbest bırak
-    free_parsed_command(&data->parsed);
-    free(data);
-    return FALSE; // GSource'u kaldır
+static int builtin_echo(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    (void)ctrl;
+    (void)err;
+    int i = 1;
+    int newline = 1;
+    if (stage->argc > 1 && strcmp(stage->argv[1], "-n") == 0) {
+        newline = 0;
+        i++;
+    }
+    for (; i < stage->argc; i++) {
+        fputs(stage->argv[i], out);
+        if (i < stage->argc - 1) fputc(' ', out);
+    }
+    if (newline) fputc('\n', out);
+    return 0;
 }
 
-Controller *controller_init(const char *username) {
-    Controller *ctrl = malloc(sizeof(Controller));
-    ctrl->model = model_init(username);
-    ctrl->view = view_init(controller_handle_input, ctrl);
-    return ctrl;
+static int builtin_pwd(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    (void)ctrl;
+    (void)stage;
+    char cwd[BUF_SIZE];
+    if (getcwd(cwd, sizeof(cwd)) == NULL) {
+        fprintf(err, "pwd: %s\n", strerror(errno));
+        return 1;
+    }
+    fprintf(out, "%s\n", cwd);
+    return 0;
 }
 
-void controller_handle_input(const char *input, void *data) {
-    Controller *ctrl = (Controller *)data;
-    char output[BUF_SIZE] = {0};
-    const int MAX_PATH_LEN = 1024;
+static int builtin_true(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    (void)ctrl;
+    (void)stage;
+    (void)out;
+    (void)err;
+    return 0;
+}
 
-    fprintf(stderr, "Controller received input: %s\n", input); // Debug için stderr'a yaz
+// history [N]: son N komut (varsayılan tümü), numaralar oturumlar arası süreklidir
+static int builtin_history(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    History *history = ctrl->model->history;
+    if (!history) return 0;
+    uint64_t begin = history_begin(history);
+    uint64_t end = history_end(history);
+    if (stage->argc > 1) {
+        long count = atol(stage->argv[1]);
+        if (count <= 0) {
+            fprintf(err, "history: invalid count: %s\n", stage->argv[1]);
+            return 1;
+        }
+        if (end - begin > (uint64_t)count) begin = end - (uint64_t)count;
+    }
+    for (uint64_t seq = begin; seq < end; seq++) {
+        fprintf(out, "%5llu  %s\n", (unsigned long long)seq + 1, history_at(history, seq));
+    }
+    return 0;
+}
 
-    // Komutu ayrıştır
-    ParsedCommand parsed;
-    parse_command(input, &parsed);
+// export AD=deger: arayüz sürecinin ortamını değiştirir, sonraki tüm komutlar miras alır
+static int builtin_export(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    extern char **environ;
+    (void)ctrl;
+    if (stage->argc < 2) {
+        for (char **env = environ; *env; env++) fprintf(out, "export %s\n", *env);
+        return 0;
+    }
+    int ret = 0;
+    for (int i = 1; i < stage->argc; i++) {
+        char *eq = strchr(stage->argv[i], '=');
+        if (!eq) continue; // Değer yoksa zaten ortamdaki değişken dışa aktarılmış sayılır
+        *eq = '\0';
+        if (stage->argv[i][0] == '\0' || setenv(stage->argv[i], eq + 1, 1) != 0) {
+            fprintf(err, "export: '%s': not a valid identifier\n", stage->argv[i]);
+            ret = 1;
+        }
+        *eq = '=';
+    }
+    return ret;
+}
 
-    if (parsed.arg_count > 0) {
-        if (strcmp(parsed.args[0], "cd") == 0) {
-            if (parsed.arg_count < 2) {
-                snprintf(output, sizeof(output), "cd: missing directory argument\n");
-                view_update_output(ctrl->view, output);
+// jobs: arka plan işleri numara sırasıyla
+static int builtin_jobs(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    (void)stage;
+    (void)err;
+    for (int i = 0; i < MAX_JOBS; i++) {
+        Job *job = ctrl->jobs[i];
+        if (!job) continue;
+        CommandData *data = job->run->command;
+        if (data) {
+            fprintf(out, "[%d] Running  %6d  %s\n", job->id, (int)data->pids[data->stage_count - 1], job->text);
+        } else {
+            fprintf(out, "[%d] %-8s %6s  %s\n", job->id, job->started ? "Running" : "Queued", "-", job->text);
+        }
+    }
+    return 0;
+}
+
+static int parse_signal(const char *name) {
+    static const struct {
+        const char *name;
+        int signal;
+    } signals[] = {
+        { "HUP", SIGHUP },   { "INT", SIGINT },   { "QUIT", SIGQUIT }, { "KILL", SIGKILL }, { "USR1", SIGUSR1 },
+        { "USR2", SIGUSR2 }, { "TERM", SIGTERM }, { "CONT", SIGCONT }, { "STOP", SIGSTOP },
+    };
+    char *end;
+    long number = strtol(name, &end, 10);
+    if (end != name && *end == '\0') return number >= 0 && number < NSIG ? (int)number : -1;
+    if (strncmp(name, "SIG", 3) == 0) name += 3;
+    for (size_t i = 0; i < sizeof(signals) / sizeof(signals[0]); i++) {
+        if (strcmp(signals[i].name, name) == 0) return signals[i].signal;
+    }
+    return -1;
+}
+
+// kill [-SIG | -s SIG] %n|pid ...: %n işin çalışan tüm aşamalarına gider
+static int builtin_kill(Controller *ctrl, Stage *stage, FILE *out, FILE *err) {
+    int sig = SIGTERM;
+    int i = 1;
+    if (i + 1 < stage->argc && strcmp(stage->argv[i], "-s") == 0) {
+        sig = parse_signal(stage->argv[i + 1]);
+        i += 2;
+    } else if (i < stage->argc && stage->argv[i][0] == '-' && stage->argv[i][1]) {
+        sig = parse_signal(stage->argv[i] + 1);
+        i++;
+    }
+    if (sig < 0) {
+        fprintf(err, "kill: %s: invalid signal specification\n", stage->argv[i - 1]);
+        return 1;
+    }
+    if (i == stage->argc) {
+        fprintf(err, "kill: usage: kill [-s sigspec | -sigspec] pid | %%job ...\n");
+        return 1;
+    }
+
+    int ret = 0;
+    for (; i < stage->argc; i++) {
+        const char *arg = stage->argv[i];
+        if (arg[0] == '%') {
+            Job *job = job_find(ctrl, arg);
+            if (job) {
+                job_signal(ctrl, job, sig);
             } else {
-                char *arg = parsed.args[1];
-                arg[MAX_PATH_LEN - 1] = '\0';
-                if (chdir(arg) == 0) {
-                    char cwd[BUF_SIZE];
-                    if (getcwd(cwd, sizeof(cwd)) != NULL) {
-                        cwd[MAX_PATH_LEN - 1] = '\0';
-                        snprintf(output, sizeof(output), "Changed directory to: %.*s\n", MAX_PATH_LEN, cwd);
-                    } else {
-                        snprintf(output, sizeof(output), "Changed directory, but failed to get current directory\n");
-                    }
-                } else {
-                    snprintf(output, sizeof(output), "cd: failed to change directory to '%.*s'\n", MAX_PATH_LEN, arg);
-                }
-                view_update_output(ctrl->view, output);
+                fprintf(err, "kill: %s: no such job\n", arg);
+                ret = 1;
             }
-            free_parsed_command(&parsed);
-        } else if (strncmp(input, "@msg ", 5) == 0) {
-            model_send_message(ctrl->model, input + 5);
-            free_parsed_command(&parsed);
-        } else if (strncmp(input, "@file ", 6) == 0) {
-            model_send_file(ctrl->model, input + 6);
-            free_parsed_command(&parsed);
-        } else if (strcmp(parsed.args[0], "nano") == 0) {
-            pid_t pid = fork();
-            if (pid == 0) {
-                const char *filename = (parsed.arg_count > 1) ? parsed.args[1] : "";
-                char nano_cmd[BUF_SIZE];
-                snprintf(nano_cmd, sizeof(nano_cmd), 
-                         "code %s -r && code -r -w --command \"workbench.action.terminal.focus\" && code -r -w --command \"workbench.action.terminal.sendSequence\" --args \"\\\"nano %s\\\"\"",
-                         filename, filename);
-                fprintf(stderr, "Executing in child: %s\n", nano_cmd); // Debug için stderr'a yaz
-                execlp("sh", "sh", "-c", nano_cmd, (char *)NULL);
-                perror("execlp failed");
-                exit(EXIT_FAILURE);
-            } else if (pid > 0) {
-                fprintf(stderr, "Spawned VS Code with nano, PID: %d\n", pid); // Debug için stderr'a yaz
-            } else {
-                perror("fork failed");
-                strncpy(output, "Error: Failed to launch nano in VS Code\n", BUF_SIZE);
-                view_update_output(ctrl->view, output);
+            continue;
+        }
+        char *end;
+        long pid = strtol(arg, &end, 10);
+        if (end == arg || *end || pid <= 0) {
+            fprintf(err, "kill: %s: arguments must be process or job IDs\n", arg);
+            ret = 1;
+        } else if (kill((pid_t)pid, sig) != 0) {
+            fprintf(err, "kill: (%ld) - %s\n", pid, strerror(errno));
+            ret = 1;
+        }
+    }
+    return ret;
+}
+
+static const Builtin builtins[] = {
+    { "cd",      builtin_cd,      BUILTIN_EXPAND },
+    { "echo",    builtin_echo,    BUILTIN_PIPE },
+    { "pwd",     builtin_pwd,     BUILTIN_PIPE },
+    { "true",    builtin_true,    BUILTIN_PIPE },
+    { "history", builtin_history, BUILTIN_PIPE },
+    { "export",  builtin_export,  BUILTIN_EXPAND },
+    { "jobs",    builtin_jobs,    BUILTIN_PIPE },
+    { "kill",    builtin_kill,    0 },
+};
+
+static const Builtin *find_builtin(const char *name) {
+    for (size_t i = 0; i < sizeof(builtins) / sizeof(builtins[0]); i++) {
+        if (strcmp(builtins[i].name, name) == 0) return &builtins[i];
+    }
+    return NULL;
+}
+
+#define BUILTIN_MAX_FILES 8
+
+// Yerleşik komutun 1 ve 2 numaralı çıkışları: yönlendirmeler sh'deki sırayla
+// uygulanır. Diğer numaralara giden dosyalar da sh'deki gibi açılıp kapanır;
+// < dosyası okunmaz, yalnızca varlığı denetlenir.
+typedef struct {
+    FILE *out;
+    FILE *err;
+    FILE *files[BUILTIN_MAX_FILES];
+    int file_count;
+} BuiltinIO;
+
+static void builtin_io_close(BuiltinIO *io) {
+    for (int i = 0; i < io->file_count; i++) fclose(io->files[i]);
+    io->file_count = 0;
+}
+
+// Hata olursa mesajı panele yazar ve -1 döner (komut çalışmaz, durum 1)
+static int builtin_io_open(Controller *ctrl, const Builtin *builtin, Stage *stage, FILE *out, FILE *err,
+                           BuiltinIO *io) {
+    char output[BUF_SIZE];
+    io->out = out;
+    io->err = err;
+    io->file_count = 0;
+    for (const Redirect *r = stage->redirects; r; r = r->next) {
+        FILE **slot = r->fd == STDOUT_FILENO ? &io->out : r->fd == STDERR_FILENO ? &io->err : NULL;
+        if (r->type == REDIRECT_DUP) {
+            FILE *source = r->dup_fd == STDOUT_FILENO ? io->out : r->dup_fd == STDERR_FILENO ? io->err : NULL;
+            if (!source) {
+                snprintf(output, sizeof(output), "%s: %d: Bad file descriptor\n", builtin->name, r->dup_fd);
+                goto fail;
             }
-            free_parsed_command(&parsed);
+            if (slot) *slot = source;
+            continue;
+        }
+        FILE *file = NULL;
+        if (io->file_count < BUILTIN_MAX_FILES) {
+            file = fopen(r->target, r->type == REDIRECT_IN ? "r" : r->type == REDIRECT_APPEND ? "a" : "w");
         } else {
-            // Boru ve yönlendirme işlemleri
-            if (parsed.pipe_next) {
-                // Boru işlemi: Gerçek pipe kullanımı
-                int pipefd[2] = {-1, -1};
-                pid_t pids[10]; // Maksimum 10 boru için
-                int pid_count = 0;
-                int prev_read_fd = -1;
-                int output_pipefd[2] = {-1, -1}; // Son çıktıyı almak için ayrı bir boru
-                char *current_input = strdup(input);
-                ParsedCommand current_parsed;
-
-                // Son çıktıyı almak için bir boru oluştur
-                if (pipe(output_pipefd) == -1) {
-                    snprintf(output, sizeof(output), "Error: Failed to create output pipe\n");
-                    view_update_output(ctrl->view, output);
-                    free(current_input);
-                    free_parsed_command(&parsed);
-                    return;
-                }
+            errno = EMFILE;
+        }
+        if (!file) {
+            snprintf(output, sizeof(output), "%s: %s: %s\n", builtin->name, r->target, strerror(errno));
+            goto fail;
+        }
+        io->files[io->file_count++] = file;
+        if (slot && r->type != REDIRECT_IN) *slot = file;
+    }
+    return 0;
 
-                while (current_input) {
-                    parse_command(current_input, &current_parsed);
-                    free(current_input); // current_input'u serbest bırak
-
-                    // Yeni bir boru oluştur (son komut hariç)
-                    if (current_parsed.pipe_next) {
-                        if (pipe(pipefd) == -1) {
-                            snprintf(output, sizeof(output), "Error: Failed to create pipe\n");
-                            view_update_output(ctrl->view, output);
-                            free_parsed_command(&current_parsed);
-                            close(output_pipefd[0]);
-                            close(output_pipefd[1]);
-                            return;
-                        }
-                    }
-
-                    pids[pid_count] = fork();
-                    if (pids[pid_count] == 0) { // Çocuk süreç
-                        // Giriş yönlendirmesi
-                        if (prev_read_fd != -1) {
-                            dup2(prev_read_fd, STDIN_FILENO);
-                            close(prev_read_fd);
-                        }
-
-                        // Çıkış yönlendirmesi
-                        if (current_parsed.pipe_next) {
-                            close(pipefd[0]); // Okuma ucunu kapat
-                            dup2(pipefd[1], STDOUT_FILENO); // Çıktıyı pipe'a yönlendir
-                            close(pipefd[1]);
-                        } else {
-                            // Son komut: Çıktıyı output_pipefd'ye yönlendir
-                            if (current_parsed.redirect_out) {
-                                int fd = open(current_parsed.redirect_out, O_WRONLY | O_CREAT | (current_parsed.append ? O_APPEND : O_TRUNC), 0644);
-                                if (fd == -1) {
-                                    perror("Failed to open redirect file");
-                                    exit(EXIT_FAILURE);
-                                }
-                                dup2(fd, STDOUT_FILENO);
-                                close(fd);
-                            } else {
-                                close(output_pipefd[0]); // Okuma ucunu kapat
-                                dup2(output_pipefd[1], STDOUT_FILENO); // Çıktıyı output_pipefd'ye yönlendir
-                                close(output_pipefd[1]);
-                            }
-                        }
-
-                        // Komutun temel kısmını oluştur
-                        char cmd[BUF_SIZE] = {0};
-                        for (int i = 0; i < current_parsed.arg_count; i++) {
-                            strncat(cmd, current_parsed.args[i], BUF_SIZE - strlen(cmd) - 1);
-                            if (i < current_parsed.arg_count - 1) strncat(cmd, " ", BUF_SIZE - strlen(cmd) - 1);
-                        }
-                        fprintf(stderr, "Executing command in child: %s\n", cmd); // Debug için stderr'a yaz
-
-                        execlp("sh", "sh", "-c", cmd, (char *)NULL);
-                        perror("execlp failed");
-                        exit(EXIT_FAILURE);
-                    }
-
-                    // Ana süreç: Boruyu kapat ve bir sonraki komuta geç
-                    if (prev_read_fd != -1) {
-                        close(prev_read_fd);
-                    }
-                    if (current_parsed.pipe_next) {
-                        close(pipefd[1]); // Yazma ucunu kapat
-                        prev_read_fd = pipefd[0]; // Okuma ucunu bir sonraki komut için sakla
-                        current_input = strdup(current_parsed.pipe_next);
-                        pid_count++;
-                    } else {
-                        current_input = NULL;
-                        if (prev_read_fd != -1) {
-                            close(prev_read_fd);
-                        }
-                        if (pipefd[1] != -1) {
-                            close(pipefd[1]);
-                        }
-                    }
-
-                    free_parsed_command(&current_parsed);
-                }
+fail:
+    builtin_io_close(io);
+    append_output(ctrl, output);
+    return -1;
+}
 
-                // Tüm süreçlerin tamamlanmasını bekle
-                for (int i = 0; i <= pid_count; i++) {
-                    int status;
-                    waitpid(pids[i], &status, 0);
-                    fprintf(stderr, "Child process %d exited with status %d\n", pids[i], WEXITSTATUS(status)); // Debug için stderr'a yaz
-                }
+// Yerleşik komutu çalıştır; yönlendirilmeyen çıktı ve hatalar çıktı paneline gider
+static int run_builtin(Controller *ctrl, const Builtin *builtin, Stage *stage) {
+    const Redirect *redirect = stdout_redirect(stage);
+    char output[BUF_SIZE];
+    char *buffer = NULL;
+    size_t size = 0;
+    BuiltinIO io;
 
-                // Son çıktıyı output_pipefd'den oku
-                close(output_pipefd[1]); // Yazma ucunu kapat
-                if (!parsed.redirect_out) {
-                    char buffer[BUF_SIZE] = {0};
-                    ssize_t n = read(output_pipefd[0], buffer, BUF_SIZE - 1);
-                    if (n > 0) {
-                        buffer[n] = '\0';
-                        strncpy(output, buffer, BUF_SIZE - 1);
-                        fprintf(stderr, "Pipe output: %s\n", output); // Debug için stderr'a yaz
-                    } else {
-                        snprintf(output, sizeof(output), "No output from pipe\n");
-                        fprintf(stderr, "No data read from output_pipefd\n"); // Debug için stderr'a yaz
-                    }
-                } else {
-                    snprintf(output, sizeof(output), "Output redirected to %s\n", parsed.redirect_out);
-                }
-                close(output_pipefd[0]);
+    FILE *pane = open_memstream(&buffer, &size);
+    if (!pane) {
+        append_output(ctrl, "Error: Failed to run builtin\n");
+        return 1;
+    }
+    if (builtin_io_open(ctrl, builtin, stage, pane, pane, &io) == -1) {
+        fclose(pane);
+        free(buffer);
+        return 1;
+    }
 
-                // Çıktıyı göster
-                view_update_output(ctrl->view, output);
-            } else {
-                // Boru yoksa, komutu asenkron çalıştır
-                CommandData *data = malloc(sizeof(CommandData));
-                data->ctrl = ctrl;
-                strncpy(data->command, input, BUF_SIZE - 1);
-                data->command[BUF_SIZE - 1] = '\0';
-                data->output[0] = '\0';
-                data->parsed = parsed; // Yönlendirme bilgilerini sakla
-
-                if (pipe(data->pipefd) == -1) {
-                    snprintf(output, sizeof(output), "Error: Failed to create pipe\n");
-                    view_update_output(ctrl->view, output);
-                    free(data);
-                    free_parsed_command(&parsed);
-                    return;
-                }
+    int status = builtin->run(ctrl, stage, io.out, io.err);
+    builtin_io_close(&io);
+    fclose(pane);
 
-                data->pid = fork();
-                if (data->pid == 0) { // Çocuk süreç
-                    close(data->pipefd[0]); // Okuma ucunu kapat
-                    dup2(data->pipefd[1], STDOUT_FILENO); // Çıktıyı pipe'a yönlendir
-                    dup2(data->pipefd[1], STDERR_FILENO); // Hataları da pipe'a yönlendir
-                    close(data->pipefd[1]);
-
-                    // Yönlendirme varsa
-                    if (parsed.redirect_out) {
-                        int fd = open(parsed.redirect_out, O_WRONLY | O_CREAT | (parsed.append ? O_APPEND : O_TRUNC), 0644);
-                        if (fd == -1) {
-                            perror("Failed to open redirect file");
-                            exit(EXIT_FAILURE);
-                        }
-                        dup2(fd, STDOUT_FILENO);
-                        close(fd);
-                    }
-
-                    // Komutu çalıştır
-                    model_execute_command(ctrl->model, data->command, data->output, BUF_SIZE);
-                    exit(0);
-                } else if (data->pid > 0) {
-                    // Ana süreç: Komut tamamlandığında çağrılacak geri çağrıyı ayarla
-                    g_idle_add(command_finished, data);
-                } else {
-                    perror("fork failed");
-                    snprintf(output, sizeof(output), "Error: Failed to execute command\n");
-                    view_update_output(ctrl->view, output);
-                    free(data);
-                    free_parsed_command(&parsed);
-                }
-                return; // parsed'i burada serbest bırakmamak için return
+    output_push(ctrl, buffer, size);
+    free(buffer);
+    if (redirect && io.out != pane) {
+        snprintf(output, sizeof(output), "Output redirected to %s\n", redirect->target);
+        append_output(ctrl, output);
+    }
+    return status;
+}
+
+// cd ve export sh'ye gitse değişiklik çocukta kalırdı: aşamanın ham metni
+// wordexp ile süreç içinde genişletilir. Komut yerine koyma ve yönlendirme
+// gibi çözülemeyen biçimler açık bir hatayla reddedilir.
+static int run_builtin_expanded(Controller *ctrl, const Builtin *builtin, Stage *stage) {
+    char output[BUF_SIZE];
+    wordexp_t words;
+    int err = wordexp(stage->text, &words, WRDE_NOCMD);
+    if (err != 0) {
+        const char *reason = err == WRDE_CMDSUB ? "command substitution is not supported"
+                           : err == WRDE_BADCHAR ? "redirections and operators are not supported here"
+                           : err == WRDE_SYNTAX ? "syntax error"
+                           : "expansion failed";
+        snprintf(output, sizeof(output), "%s: %s\n", builtin->name, reason);
+        append_output(ctrl, output);
+        if (err == WRDE_NOSPACE) wordfree(&words);
+        return 1;
+    }
+    Stage expanded = *stage;
+    expanded.argv = words.we_wordv;
+    expanded.argc = (int)words.we_wordc;
+    expanded.needs_shell = 0;
+    int status = expanded.argc > 0 ? run_builtin(ctrl, builtin, &expanded) : 0;
+    wordfree(&words);
+    return status;
+}
+
+// Boru hattının başındaki yerleşik komutun çıktısı bir bellek dosyasına
+// yazılır; boru kapasitesini aşan çıktı da ana döngüyü bloklamaz
+static int run_builtin_input(Controller *ctrl, const Builtin *builtin, Stage *stage) {
+    int fd = memfd_create("builtin", MFD_CLOEXEC);
+    if (fd < 0) return -1;
+    int out_fd = dup(fd);
+    FILE *out = out_fd >= 0 ? fdopen(out_fd, "w") : NULL;
+    char *buffer = NULL;
+    size_t size = 0;
+    FILE *pane = out ? open_memstream(&buffer, &size) : NULL;
+    if (!pane) {
+        if (out) fclose(out);
+        else if (out_fd >= 0) close(out_fd);
+        close(fd);
+        return -1;
+    }
+    // Hatalar boruya değil panele gider; yönlendirme açılamazsa boru boş kalır
+    BuiltinIO io;
+    if (builtin_io_open(ctrl, builtin, stage, out, pane, &io) == 0) {
+        builtin->run(ctrl, stage, io.out, io.err);
+        builtin_io_close(&io);
+    }
+    fclose(out);
+    fclose(pane);
+    output_push(ctrl, buffer, size);
+    free(buffer);
+    lseek(fd, 0, SEEK_SET);
+    return fd;
+}
+
+// nano'yu VS Code terminalinde aç; çıktısı izlenmez
+static int launch_nano(Controller *ctrl, Stage *stage) {
+    const char *filename = (stage->argc > 1) ? stage->argv[1] : "";
+    char nano_cmd[BUF_SIZE];
+    snprintf(nano_cmd, sizeof(nano_cmd), 
+             "code %s -r && code -r -w --command \"workbench.action.terminal.focus\" && code -r -w --command \"workbench.action.terminal.sendSequence\" --args \"\\\"nano %s\\\"\"",
+             filename, filename);
+    LOG_DEBUG(LOG_SPAWN, "Executing: %s", nano_cmd);
+
+    SpawnRequest req;
+    spawn_request_init(&req);
+    req.shell_command = nano_cmd;
+    pid_t pid = model_spawn_command(ctrl->model, nano_cmd, &req);
+    if (pid < 0) {
+        perror("spawn failed");
+        append_output(ctrl, "Error: Failed to launch nano in VS Code\n");
+        return 1;
+    }
+    LOG_DEBUG(LOG_SPAWN, "Spawned VS Code with nano, PID: %d", pid);
+    g_child_watch_add(pid, on_detached_exit, ctrl);
+    return 0;
+}
+
+// Satır bitti; arka plan işinin satırı işle birlikte serbest kalır
+static void run_finish(LineRun *run) {
+    Controller *ctrl = run->ctrl;
+    if (run->job) {
+        job_finished(ctrl, run->job, run->last_status);
+        return;
+    }
+    run_free(run);
+    if (--ctrl->running == 0) {
+        // Satırın son çıktısı bir sonraki kareyi beklemeden görünsün
+        output_flush_all(ctrl);
+        view_command_done(ctrl->view);
+    }
+}
+
+// Sıradaki boru hattını koşuluna göre çalıştır. Yerleşik komutlar anında biter;
+// dış komutlar başlatılınca döner ve command_finished buradan devam ettirir.
+static void run_continue(LineRun *run) {
+    Controller *ctrl = run->ctrl;
+    while (run->next) {
+        Pipeline *pipeline = run->next;
+        run->next = pipeline->next;
+
+        // & bütün && / || listesine uygulanır: liste tek iş olur, satır beklemeden sürer
+        if (pipeline->condition == RUN_ALWAYS) {
+            Pipeline *last = pipeline;
+            while (last->next && last->next->condition != RUN_ALWAYS) last = last->next;
+            if (last->background) {
+                run->next = last->next;
+                run->last_status = job_add(ctrl, pipeline, last);
+                continue;
             }
         }
+
+        if (pipeline->condition == RUN_IF_SUCCESS && run->last_status != 0) continue;
+        if (pipeline->condition == RUN_IF_FAILURE && run->last_status == 0) continue;
+
+        Stage *stage = pipeline->stages;
+        if (run->line->needs_shell) {
+            // Satırın tamamı sh'ye gidiyor ($(...), alt kabuk...): cd/export ile
+            // başlıyorsa etkisi çocukta kaybolacağı için açıkça reddedilir
+            char word[16];
+            size_t skip = strspn(stage->text, " \t");
+            size_t len = strcspn(stage->text + skip, " \t;&|<>()$`'\"");
+            const Builtin *builtin = NULL;
+            if (len < sizeof(word)) {
+                memcpy(word, stage->text + skip, len);
+                word[len] = '\0';
+                builtin = find_builtin(word);
+            }
+            if (builtin && (builtin->flags & BUILTIN_EXPAND)) {
+                run->last_status = run_builtin_expanded(ctrl, builtin, stage);
+                continue;
+            }
+        }
+        if (pipeline->stage_count == 1 && stage->argc > 0) {
+            const Builtin *builtin = find_builtin(stage->argv[0]);
+            if (builtin && !stage->needs_shell) {
+                // Yerleşik komut: fork/exec yok
+                run->last_status = run_builtin(ctrl, builtin, stage);
+                continue;
+            }
+            if (builtin && (builtin->flags & BUILTIN_EXPAND)) {
+                run->last_status = run_builtin_expanded(ctrl, builtin, stage);
+                continue;
+            }
+            if (strcmp(stage->argv[0], "nano") == 0 && !stage->needs_shell) {
+                run->last_status = launch_nano(ctrl, stage);
+                continue;
+            }
+            if (strcmp(stage->argv[0], "fg") == 0 && !stage->needs_shell) {
+                // İş bitince job_finished devam ettirir
+                if (job_foreground(ctrl, run, stage) == 0) return;
+                continue;
+            }
+        }
+
+        // history | grep foo: ilk aşama süreç içinde çalışır, çıktısı ikincinin girişi olur
+        int input_fd = -1;
+        if (pipeline->stage_count > 1 && stage->argc > 0 && !stage->needs_shell) {
+            const Builtin *builtin = find_builtin(stage->argv[0]);
+            if (builtin && (builtin->flags & BUILTIN_PIPE)) input_fd = run_builtin_input(ctrl, builtin, stage);
+        }
+
+        if (start_pipeline(ctrl, run, pipeline, input_fd) == 0) {
+            if (run->job) job_announce(run->job);
+            return;
+        }
+    }
+    run_finish(run);
+}
+
+Controller *controller_init(const char *username) {
+    Controller *ctrl = malloc(sizeof(Controller));
+    ctrl->spare_parser = NULL;
+    ctrl->pending = g_string_sized_new(BUF_SIZE);
+    ctrl->flush_source = 0;
+    ctrl->paused = NULL;
+    ctrl->running = 0;
+    ctrl->flushed = 0;
+    ctrl->render_head = ctrl->render_tail = NULL;
+    memset(ctrl->jobs, 0, sizeof(ctrl->jobs));
+    ctrl->job_count = 0;
+    ctrl->jobs_running = 0;
+    ctrl->job_limit = JOB_LIMIT;
+    const char *limit = getenv("TERMINAL_MAX_JOBS");
+    if (limit && atoi(limit) > 0) ctrl->job_limit = atoi(limit);
+    ctrl->job_order = 0;
+    ctrl->model = model_init(username);
+    ctrl->view = view_init(controller_handle_input, ctrl);
+    return ctrl;
+}
+
+// @search sonucunu çıktı bölmesine tek satır olarak yazar
+static void print_search_result(const MessageEntry *entry, void *data) {
+    Controller *ctrl = (Controller *)data;
+    char timestamp[32];
+    char line[BUF_SIZE + MAX_COMMAND + 96];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&entry->timestamp));
+    if (entry->type == 0) {
+        snprintf(line, sizeof(line), "#%llu [%s] [%s] %s\n", (unsigned long long)entry->seq, entry->sender,
+                 timestamp, entry->data);
+    } else {
+        snprintf(line, sizeof(line), "#%llu [%s] [%s] File: %s (%llu bytes)\n", (unsigned long long)entry->seq,
+                 entry->sender, timestamp, entry->filename, (unsigned long long)entry->file_size);
+    }
+    append_output(ctrl, line);
+}
+
+// @stats [reset | save <path>]: süreç gecikme/kaynak histogramları
+static void stats_command(Controller *ctrl, const char *args) {
+    char output[BUF_SIZE];
+    while (*args == ' ') args++;
+    if (strcmp(args, "reset") == 0) {
+        stats_reset(ctrl->model->stats);
+        append_output(ctrl, "Stats reset\n");
+    } else if (strncmp(args, "save ", 5) == 0 && args[5]) {
+        const char *path = args + 5;
+        if (model_export_stats(ctrl->model, path) == 0) {
+            snprintf(output, sizeof(output), "Stats saved to %s\n", path);
+        } else {
+            snprintf(output, sizeof(output), "Error: Failed to save stats to %s: %s\n", path, strerror(errno));
+        }
+        append_output(ctrl, output);
+    } else if (*args) {
+        append_output(ctrl, "Usage: @stats [reset | save <path>]\n");
+    } else {
+        char *buffer = NULL;
+        size_t size = 0;
+        FILE *out = open_memstream(&buffer, &size);
+        if (!out) {
+            append_output(ctrl, "Error: Out of memory\n");
+            return;
+        }
+        stats_print(ctrl->model->stats, out);
+        fclose(out);
+        output_push(ctrl, buffer, size);
+        free(buffer);
     }
+}
+
+void controller_handle_input(const char *input, void *data) {
+    Controller *ctrl = (Controller *)data;
+    char output[BUF_SIZE] = {0};
+
+    LOG_DEBUG(LOG_CONTROLLER, "Controller received input: %s", input);
+
+    if (strncmp(input, "@msg ", 5) == 0) {
+        if (model_send_message(ctrl->model, input + 5) == -1) append_output(ctrl, "message dropped\n");
+        return;
+    } else if (strncmp(input, "@file -z ", 9) == 0) {
+        // Diğer hatalar modelde zaten bildirildi; yalnızca düşen mesaj burada gösterilir
+        if (model_send_file(ctrl->model, input + 9, 1) == -1 && errno == EAGAIN) {
+            append_output(ctrl, "message dropped\n");
+        }
+        return;
+    } else if (strncmp(input, "@file ", 6) == 0) {
+        if (model_send_file(ctrl->model, input + 6, 0) == -1 && errno == EAGAIN) {
+            append_output(ctrl, "message dropped\n");
+        }
+        return;
+    } else if (strncmp(input, "@save ", 6) == 0) {
+        // @save <id> [path]
+        char *end;
+        unsigned long long id = strtoull(input + 6, &end, 10);
+        if (end == input + 6) {
+            append_output(ctrl, "Usage: @save <id> [path]\n");
+            return;
+        }
+        while (*end == ' ') end++;
+        model_save_file(ctrl->model, id, end, output, sizeof(output));
+        append_output(ctrl, output);
+        return;
+    } else if (strncmp(input, "@search ", 8) == 0) {
+        // @search <terms>: tüm kelimeleri içeren en yeni 20 mesaj
+        snprintf(output, sizeof(output), "Search: %s\n", input + 8);
+        append_output(ctrl, output);
+        size_t total = model_search(ctrl->model, input + 8, 20, print_search_result, ctrl);
+        snprintf(output, sizeof(output), total > 20 ? "%zu matches, showing newest 20\n" : "%zu matches\n", total);
+        append_output(ctrl, output);
+        return;
+    } else if (strncmp(input, "@autosave ", 10) == 0) {
+        // @autosave <dir|off>
+        const char *dir = input + 10;
+        model_set_autosave(ctrl->model, dir);
+        snprintf(output, sizeof(output), ctrl->model->autosave_dir ? "Autosave to %s\n" : "Autosave off\n", dir);
+        append_output(ctrl, output);
+        return;
+    } else if (strncmp(input, "@stats", 6) == 0 && (input[6] == '\0' || input[6] == ' ')) {
+        stats_command(ctrl, input + 6);
+        return;
+    }
+
+    // Komutu ayrıştır (önceki satırın arenası yeniden kullanılır)
+    Parser *parser = ctrl->spare_parser ? ctrl->spare_parser : parser_new();
+    ctrl->spare_parser = NULL;
+    if (!parser) {
+        append_output(ctrl, "Error: Out of memory\n");
+        return;
+    }
+    CommandLine *line = parser_parse(parser, input);
+
+    LineRun *run = run_new(ctrl, parser, line);
+    ctrl->running++;
+
+    if (!line) {
+        snprintf(output, sizeof(output), "Error: %s\n", parser_error(parser));
+        output_flush_all(ctrl);
+        view_append_command(ctrl->view, input);
+        append_output(ctrl, output);
+        run_finish(run);
+        return;
+    }
+    if (line->pipeline_count == 0) { // Boş satır ya da yalnızca yorum
+        run_finish(run);
+        return;
+    }
+
+    model_add_history(ctrl->model, input);
+    output_flush_all(ctrl);
+    view_append_command(ctrl->view, input);
+    run_continue(run);
+}
 
-    free_parsed_command(&parsed);
+int controller_idle(Controller *controller) {
+    return controller->running == 0;
+}
+
+int controller_jobs(Controller *controller) {
+    return controller->job_count;
 }
 
 void controller_destroy(Controller *controller) {
+    // Pencere kapanınca çalışan işler shell'deki gibi SIGHUP alır
+    for (int i = 0; i < MAX_JOBS; i++) {
+        Job *job = controller->jobs[i];
+        if (!job) continue;
+        if (job->started) job_signal(controller, job, SIGHUP);
+        job_free(job);
+    }
+    output_flush_all(controller);
+    while (controller->render_head) {
+        RenderWait *wait = controller->render_head;
+        controller->render_head = wait->next;
+        free(wait);
+    }
+    g_string_free(controller->pending, TRUE);
     view_destroy(controller->view);
     model_destroy(controller->model);
+    parser_free(controller->spare_parser);
     free(controller);
 }
 
-int main() {
+static int run_session(const char *username) {
+    Controller *ctrl = controller_init(username);
+    view_run(ctrl->view);
+    controller_destroy(ctrl);
+    return 0;
+}
+
+// Kullanım: terminal [--users N] | [--attach NAME]
+// --users N: User1..UserN pencerelerini ayrı süreçlerde açar (varsayılan 2)
+// --attach NAME: tek bir pencereyle var olan oturuma katılır
+int main(int argc, char **argv) {
+    int users = 2;
+    const char *attach = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--users") == 0 && i + 1 < argc) {
+            users = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--attach") == 0 && i + 1 < argc) {
+            attach = argv[++i];
+        } else {
+            fprintf(stderr, "Usage: %s [--users N] [--attach NAME]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (users < 1 || users > 256) {
+        fprintf(stderr, "--users must be between 1 and 256\n");
+        return 1;
+    }
+
+    // Başsız arka uçta tek oturum; stdin/stdout komut kanalıdır, terminale yönlendirilmez
+    if (view_is_headless()) return run_session(attach ? attach : "User1");
+
     // Standart çıktıyı kontrol et ve gerekirse sıfırla
     freopen("/dev/tty", "w", stdout);
     freopen("/dev/tty", "w", stderr);
-    fprintf(stderr, "Debug output enabled\n"); // Debug için stderr'a yaz
-
-    pid_t pid = fork();
-    if (pid == 0) {
-        Controller *ctrl = controller_init("User2");
-        gtk_main();
-        controller_destroy(ctrl);
-        exit(0);
-    } else if (pid > 0) {
-        Controller *ctrl = controller_init("User1");
-        gtk_main();
-        controller_destroy(ctrl);
-        wait(NULL);
-    } else {
-        perror("fork failed");
-        return 1;
+    LOG_INFO(LOG_CONTROLLER, "Starting %d session(s)", attach ? 1 : users);
+
+    if (attach) return run_session(attach);
+
+    // User2..UserN çocuk süreçlerde, User1 ana süreçte çalışır
+    for (int i = 2; i <= users; i++) {
+        pid_t pid = fork();
+        if (pid == 0) {
+            char username[MAX_USERNAME];
+            snprintf(username, sizeof(username), "User%d", i);
+            run_session(username);
+            exit(0);
+        } else if (pid < 0) {
+            perror("fork failed");
+            break;
+        }
     }
+    run_session("User1");
+    while (wait(NULL) > 0) {}
     return 0;
-}
\ No newline at end of file
+}
@@ -1,16 +1,36 @@
 #ifndef CONTROLLER_H
 #define CONTROLLER_H
 
+#include <glib.h>
 #include "model.h"
 #include "view.h"
+#include "parser.h"
+
+#define MAX_JOBS 64  // İş tablosu kapasitesi (çalışan + sırada bekleyen)
+#define JOB_LIMIT 8  // Varsayılan eşzamanlı arka plan işi (TERMINAL_MAX_JOBS ile değişir)
 
 typedef struct {
     Model *model;
     View *view;
+    Parser *spare_parser; // Bir sonraki satır için hazır arena
+    GString *pending;     // Bir sonraki karede görünüme yazılacak çıktı
+    guint flush_source;   // Kare zamanlayıcısı (0 = bekleyen çıktı yok)
+    struct CommandData *paused; // Birikim eşiği aşıldığı için borusu okunmayan komutlar
+    int running;          // Henüz bitmemiş komut satırı sayısı
+    uint64_t flushed;     // Görünüme verilen toplam çıktı baytı
+    struct RenderWait *render_head; // Çıktısının sonu henüz görünüme verilmemiş biten komutlar
+    struct RenderWait *render_tail;
+    struct Job *jobs[MAX_JOBS]; // %n numaralı iş jobs[n - 1]'de (NULL = boş)
+    int job_count;        // Tablodaki iş sayısı
+    int jobs_running;     // Başlatılmış arka plan işi sayısı
+    int job_limit;        // Bunun üstündeki işler sırada bekler
+    uint64_t job_order;   // Sıradaki işlerin geliş sırası için sayaç
 } Controller;
 
 Controller *controller_init(const char *username);
 void controller_handle_input(const char *input, void *data);
+int controller_idle(Controller *controller);
+int controller_jobs(Controller *controller);
 void controller_destroy(Controller *controller);
 
 #endif
\ No newline at end of file
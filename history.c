@@ -0,0 +1,443 @@
+#define _GNU_SOURCE
+#include "history.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Komutlar halkada entries[seq % capacity] konumunda durur; ekleme ve düşürme
+// O(1). Trie her komutun ilk TRIE_DEPTH baytını tutar, her düğümde o önekle
+// başlayan komutların artan seq listesi var. Düşen komut her listenin başında
+// olduğu için listeden head ilerletilerek çıkarılır; listesi boşalan düğümler
+// yarıyı geçince trie halkadaki komutlardan yeniden kurulur.
+#define TRIE_DEPTH 16
+#define TRIE_MIN_REBUILD 1024 // Bundan küçük trie hiç yeniden kurulmaz
+#define WRITE_BUFFER 4096
+#define BASE_HEADER "#base " // Dosyanın ilk satırı: küçültmede düşen komut sayısı
+
+typedef struct {
+    uint32_t head;      // Düşmüş girdiler [0, head) aralığında
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t *seqs;
+} Node;
+
+struct History {
+    char **entries;
+    size_t capacity;
+    uint64_t begin;     // Halkadaki en eski komut
+    uint64_t end;       // Sıradaki komutun numarası
+
+    Node *nodes;        // nodes[0] kök; boş önek trie'ye uğramaz
+    size_t node_count;
+    size_t node_capacity;
+    size_t dead_nodes;  // Listesindeki tüm komutlar düşmüş düğümler
+    uint64_t *edge_keys; // (ebeveyn << 8 | bayt) + 1, boş yuvada 0
+    uint32_t *edge_children;
+    size_t edge_capacity; // İkinin kuvveti
+    size_t edge_used;
+
+    int fd;             // Kalıcı dosya, yoksa -1
+    char buffer[WRITE_BUFFER];
+    size_t buffer_len;
+};
+
+static uint64_t edge_key(uint32_t parent, unsigned char byte) {
+    return ((uint64_t)parent << 8 | byte) + 1;
+}
+
+static size_t edge_slot(const History *history, uint64_t key) {
+    size_t mask = history->edge_capacity - 1;
+    size_t i = (size_t)((key * 0x9e3779b97f4a7c15ull) >> 32) & mask;
+    while (history->edge_keys[i] && history->edge_keys[i] != key) i = (i + 1) & mask;
+    return i;
+}
+
+static int grow_edges(History *history) {
+    uint64_t *old_keys = history->edge_keys;
+    uint32_t *old_children = history->edge_children;
+    size_t old_capacity = history->edge_capacity;
+    size_t capacity = old_capacity ? old_capacity * 2 : 1024;
+    uint64_t *keys = calloc(capacity, sizeof(uint64_t));
+    uint32_t *children = malloc(capacity * sizeof(uint32_t));
+    if (!keys || !children) {
+        free(keys);
+        free(children);
+        return -1;
+    }
+    history->edge_keys = keys;
+    history->edge_children = children;
+    history->edge_capacity = capacity;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (!old_keys[i]) continue;
+        size_t slot = edge_slot(history, old_keys[i]);
+        keys[slot] = old_keys[i];
+        children[slot] = old_children[i];
+    }
+    free(old_keys);
+    free(old_children);
+    return 0;
+}
+
+// Çocuğu bulur; create verilmişse yoksa oluşturur. Bulunamazsa 0 (kök asla çocuk değil).
+static uint32_t child(History *history, uint32_t parent, unsigned char byte, int create) {
+    uint64_t key = edge_key(parent, byte);
+    size_t slot = edge_slot(history, key);
+    if (history->edge_keys[slot]) return history->edge_children[slot];
+    if (!create) return 0;
+
+    if (history->node_count == history->node_capacity) {
+        size_t capacity = history->node_capacity * 2;
+        Node *nodes = realloc(history->nodes, capacity * sizeof(Node));
+        if (!nodes) return 0;
+        history->nodes = nodes;
+        history->node_capacity = capacity;
+    }
+    if ((history->edge_used + 1) * 10 > history->edge_capacity * 7) {
+        if (grow_edges(history) == -1) return 0;
+        slot = edge_slot(history, key);
+    }
+    uint32_t node = (uint32_t)history->node_count++;
+    memset(&history->nodes[node], 0, sizeof(Node));
+    history->edge_keys[slot] = key;
+    history->edge_children[slot] = node;
+    history->edge_used++;
+    return node;
+}
+
+static void node_push(Node *node, uint64_t seq) {
+    if (node->count == node->capacity) {
+        // Önce düşmüş girdilerin yerini geri kazan
+        if (node->head > 0) {
+            memmove(node->seqs, node->seqs + node->head, (node->count - node->head) * sizeof(uint64_t));
+            node->count -= node->head;
+            node->head = 0;
+        }
+        if (node->count == node->capacity) {
+            uint32_t capacity = node->capacity ? node->capacity * 2 : 2;
+            uint64_t *seqs = realloc(node->seqs, capacity * sizeof(uint64_t));
+            if (!seqs) return;
+            node->seqs = seqs;
+            node->capacity = capacity;
+        }
+    }
+    node->seqs[node->count++] = seq;
+}
+
+// Önekin trie düğümü; önek TRIE_DEPTH'ten uzunsa o derinlikteki düğüm
+static uint32_t find_node(const History *history, const char *prefix, size_t len) {
+    uint32_t node = 0;
+    for (size_t i = 0; i < len && i < TRIE_DEPTH; i++) {
+        node = child((History *)history, node, (unsigned char)prefix[i], 0);
+        if (!node) return 0;
+    }
+    return node;
+}
+
+static void trie_add(History *history, const char *command, size_t len, uint64_t seq) {
+    uint32_t node = 0;
+    for (size_t i = 0; i < len && i < TRIE_DEPTH; i++) {
+        node = child(history, node, (unsigned char)command[i], 1);
+        if (!node) return;
+        Node *n = &history->nodes[node];
+        if (n->count > 0 && n->head == n->count) history->dead_nodes--;
+        node_push(n, seq);
+    }
+}
+
+// Bedeli, düğümleri boşaltan düşürmelere bölünür; düğüm sayısı böylece
+// halkadaki komutların öneklerine bağlı kalır, yazılmış her önekle büyümez
+static void rebuild_trie(History *history) {
+    for (size_t i = 0; i < history->node_count; i++) free(history->nodes[i].seqs);
+    memset(&history->nodes[0], 0, sizeof(Node));
+    history->node_count = 1;
+    history->dead_nodes = 0;
+    memset(history->edge_keys, 0, history->edge_capacity * sizeof(uint64_t));
+    history->edge_used = 0;
+    for (uint64_t seq = history->begin; seq < history->end; seq++) {
+        const char *command = history->entries[seq % history->capacity];
+        if (command) trie_add(history, command, strnlen(command, TRIE_DEPTH), seq);
+    }
+}
+
+static void insert(History *history, const char *command, size_t len) {
+    // Halka doluysa en eskiyi düşür ve trie listelerinin başından çıkar
+    if (history->end - history->begin == history->capacity) {
+        char **slot = &history->entries[history->begin % history->capacity];
+        uint32_t node = 0;
+        for (size_t i = 0; (*slot)[i] && i < TRIE_DEPTH; i++) {
+            node = child(history, node, (unsigned char)(*slot)[i], 0);
+            if (!node) break;
+            Node *n = &history->nodes[node];
+            if (n->head < n->count && n->seqs[n->head] == history->begin) {
+                n->head++;
+                if (n->head == n->count) history->dead_nodes++;
+            }
+        }
+        free(*slot);
+        *slot = NULL;
+        history->begin++;
+        if (history->node_count > TRIE_MIN_REBUILD && history->dead_nodes * 2 > history->node_count) {
+            rebuild_trie(history);
+        }
+    }
+
+    char *copy = strndup(command, len);
+    if (!copy) return;
+    uint64_t seq = history->end++;
+    history->entries[seq % history->capacity] = copy;
+    trie_add(history, command, len, seq);
+}
+
+static size_t count_lines(const char *text, size_t size) {
+    size_t lines = 0;
+    for (size_t at = 0; at < size;) {
+        const char *newline = memchr(text + at, '\n', size - at);
+        size_t len = newline ? (size_t)(newline - text) - at : size - at;
+        if (len > 0) lines++; // Boş satırlar sayılmaz
+        at += len + 1;
+    }
+    return lines;
+}
+
+// Dosyanın son capacity satırını mmap ile sondan geriye tarayarak bulur.
+// Numaralar oturumlar arasında sürer: ilk komutun numarası "#base N" ile
+// dosyada ondan önce kalan satırların toplamıdır. Dosya halkanın iki katını
+// aşınca aynı dosyaya yerinde yeni taban ve son capacity satır yazılır;
+// diğer pencerelerin eklemeleri bu sırada flock ile bekler.
+static void load(History *history, const char *path) {
+    int fd = open(path, O_RDWR | O_CLOEXEC);
+    if (fd < 0) return;
+    flock(fd, LOCK_EX);
+    struct stat st;
+    const char *map = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (map == MAP_FAILED) {
+        flock(fd, LOCK_UN);
+        close(fd);
+        return;
+    }
+
+    size_t size = st.st_size;
+    size_t body = 0;
+    uint64_t base = 0;
+    if (size > strlen(BASE_HEADER) && memcmp(map, BASE_HEADER, strlen(BASE_HEADER)) == 0) {
+        base = strtoull(map + strlen(BASE_HEADER), NULL, 10);
+        const char *newline = memchr(map, '\n', size);
+        body = newline ? (size_t)(newline - map) + 1 : size;
+    }
+
+    size_t start = size;
+    size_t end = size > body && map[size - 1] == '\n' ? size - 1 : size;
+    size_t lines = 0;
+    while (lines < history->capacity && end > body) {
+        const char *newline = memrchr(map + body, '\n', end - body);
+        start = newline ? (size_t)(newline - map) + 1 : body;
+        if (end > start) lines++;
+        if (!newline) break;
+        end = start - 1;
+    }
+    if (start < body) start = body;
+    size_t dropped = count_lines(map + body, start - body);
+    history->begin = history->end = base + dropped;
+
+    // Kuyruk mmap'ten kopyalanır: dosya yerinde yeniden yazılınca eşlem bozulur
+    size_t tail_size = size - start;
+    char header[64];
+    int header_len = snprintf(header, sizeof(header), BASE_HEADER "%llu\n", (unsigned long long)(base + dropped));
+    char *copy = malloc((size_t)header_len + tail_size);
+    if (copy) {
+        memcpy(copy, header, (size_t)header_len);
+        memcpy(copy + header_len, map + start, tail_size);
+    }
+    munmap((void *)map, size);
+    if (!copy) {
+        flock(fd, LOCK_UN);
+        close(fd);
+        return;
+    }
+    if (dropped > history->capacity) {
+        size_t total = (size_t)header_len + tail_size;
+        if (pwrite(fd, copy, total, 0) == (ssize_t)total) {
+            if (ftruncate(fd, (off_t)total) == -1) perror("Failed to compact history file");
+        } else {
+            perror("Failed to compact history file");
+        }
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+
+    const char *tail = copy + header_len;
+    for (size_t at = 0; at < tail_size;) {
+        const char *newline = memchr(tail + at, '\n', tail_size - at);
+        size_t len = newline ? (size_t)(newline - tail) - at : tail_size - at;
+        if (len > 0) insert(history, tail + at, len);
+        at += len + 1;
+    }
+    free(copy);
+}
+
+History *history_new(size_t capacity, const char *path) {
+    History *history = calloc(1, sizeof(History));
+    if (!history) return NULL;
+    history->capacity = capacity ? capacity : 1;
+    history->entries = calloc(history->capacity, sizeof(char *));
+    history->node_capacity = 1024;
+    history->nodes = malloc(history->node_capacity * sizeof(Node));
+    if (!history->entries || !history->nodes || grow_edges(history) == -1) {
+        free(history->entries);
+        free(history->nodes);
+        free(history);
+        return NULL;
+    }
+    memset(&history->nodes[0], 0, sizeof(Node));
+    history->node_count = 1;
+    history->fd = -1;
+
+    if (path && path[0]) {
+        load(history, path);
+        history->fd = open(path, O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+        if (history->fd < 0) perror("Failed to open history file");
+    }
+    return history;
+}
+
+// Tampondaki tam satırları tek write ile ekler; O_APPEND sayesinde
+// aynı dosyayı kullanan pencerelerin satırları karışmaz
+void history_flush(History *history) {
+    if (!history || history->fd < 0 || history->buffer_len == 0) return;
+    flock(history->fd, LOCK_SH); // Başka bir pencere dosyayı küçültüyorsa bitmesini bekle
+    if (write(history->fd, history->buffer, history->buffer_len) != (ssize_t)history->buffer_len) {
+        perror("Failed to write history file");
+    }
+    flock(history->fd, LOCK_UN);
+    history->buffer_len = 0;
+}
+
+void history_free(History *history) {
+    if (!history) return;
+    history_flush(history);
+    if (history->fd >= 0) close(history->fd);
+    for (size_t i = 0; i < history->capacity; i++) free(history->entries[i]);
+    for (size_t i = 0; i < history->node_count; i++) free(history->nodes[i].seqs);
+    free(history->entries);
+    free(history->nodes);
+    free(history->edge_keys);
+    free(history->edge_children);
+    free(history);
+}
+
+void history_add(History *history, const char *command) {
+    size_t len = strlen(command);
+    // Boş, çok satırlı ya da bir öncekinin aynısı olan komutları atla
+    if (len == 0 || memchr(command, '\n', len)) return;
+    if (history->end > history->begin) {
+        const char *last = history->entries[(history->end - 1) % history->capacity];
+        if (last && strcmp(last, command) == 0) return;
+    }
+    insert(history, command, len);
+
+    if (history->fd < 0) return;
+    if (history->buffer_len + len + 1 > WRITE_BUFFER) history_flush(history);
+    if (len + 1 > WRITE_BUFFER) {
+        char *line = malloc(len + 1);
+        if (!line) return;
+        memcpy(line, command, len);
+        line[len] = '\n';
+        flock(history->fd, LOCK_SH);
+        if (write(history->fd, line, len + 1) != (ssize_t)(len + 1)) perror("Failed to write history file");
+        flock(history->fd, LOCK_UN);
+        free(line);
+        return;
+    }
+    memcpy(history->buffer + history->buffer_len, command, len);
+    history->buffer[history->buffer_len + len] = '\n';
+    history->buffer_len += len + 1;
+}
+
+uint64_t history_begin(const History *history) {
+    return history->begin;
+}
+
+uint64_t history_end(const History *history) {
+    return history->end;
+}
+
+const char *history_at(const History *history, uint64_t seq) {
+    if (seq < history->begin || seq >= history->end) return NULL;
+    return history->entries[seq % history->capacity];
+}
+
+// Önek derinlik sınırını aşıyorsa adayın tamamını karşılaştır
+static int matches(const History *history, uint64_t seq, const char *prefix, size_t len) {
+    return len <= TRIE_DEPTH || strncmp(history_at(history, seq), prefix, len) == 0;
+}
+
+// before'dan küçük ve önekle başlayan en yeni komut; yoksa -1
+int64_t history_prev(const History *history, const char *prefix, uint64_t before) {
+    if (before > history->end) before = history->end;
+    size_t len = strlen(prefix);
+    if (len == 0) return before > history->begin ? (int64_t)(before - 1) : -1;
+    uint32_t node = find_node(history, prefix, len);
+    if (!node) return -1;
+
+    const Node *n = &history->nodes[node];
+    uint32_t lo = n->head, hi = n->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (n->seqs[mid] < before) lo = mid + 1;
+        else hi = mid;
+    }
+    while (lo > n->head) {
+        uint64_t seq = n->seqs[--lo];
+        if (matches(history, seq, prefix, len)) return (int64_t)seq;
+    }
+    return -1;
+}
+
+// after'dan büyük ve önekle başlayan en eski komut; yoksa -1
+int64_t history_next(const History *history, const char *prefix, uint64_t after) {
+    size_t len = strlen(prefix);
+    if (len == 0) {
+        uint64_t seq = after + 1 > history->begin ? after + 1 : history->begin;
+        return seq < history->end ? (int64_t)seq : -1;
+    }
+    uint32_t node = find_node(history, prefix, len);
+    if (!node) return -1;
+
+    const Node *n = &history->nodes[node];
+    uint32_t lo = n->head, hi = n->count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (n->seqs[mid] <= after) lo = mid + 1;
+        else hi = mid;
+    }
+    for (; lo < n->count; lo++) {
+        if (matches(history, n->seqs[lo], prefix, len)) return (int64_t)n->seqs[lo];
+    }
+    return -1;
+}
+
+// Ctrl-R: before'dan küçük ve metni herhangi bir yerinde içeren en yeni komut; yoksa -1.
+// Halka sınırlı olduğu için düz tarama yeterince hızlı
+int64_t history_search_prev(const History *history, const char *text, uint64_t before) {
+    if (before > history->end) before = history->end;
+    for (uint64_t seq = before; seq > history->begin; seq--) {
+        const char *command = history_at(history, seq - 1);
+        if (command && strstr(command, text)) return (int64_t)(seq - 1);
+    }
+    return -1;
+}
+
+// after'dan büyük ve metni içeren en eski komut; yoksa -1
+int64_t history_search_next(const History *history, const char *text, uint64_t after) {
+    for (uint64_t seq = after + 1 > history->begin ? after + 1 : history->begin; seq < history->end; seq++) {
+        const char *command = history_at(history, seq);
+        if (command && strstr(command, text)) return (int64_t)seq;
+    }
+    return -1;
+}
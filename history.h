@@ -0,0 +1,23 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Sabit derinlikli halka: her komutun artan bir numarası var, en eski komut
+// yenisi eklenince düşer. Önek araması için derinliği sınırlı bir trie tutar.
+typedef struct History History;
+
+History *history_new(size_t capacity, const char *path);
+void history_free(History *history);
+void history_add(History *history, const char *command);
+void history_flush(History *history);
+uint64_t history_begin(const History *history);
+uint64_t history_end(const History *history);
+const char *history_at(const History *history, uint64_t seq);
+int64_t history_prev(const History *history, const char *prefix, uint64_t before);
+int64_t history_next(const History *history, const char *prefix, uint64_t after);
+int64_t history_search_prev(const History *history, const char *text, uint64_t before);
+int64_t history_search_next(const History *history, const char *text, uint64_t after);
+
+#endif
@@ -0,0 +1,225 @@
+#define _GNU_SOURCE
+#include "log.h"
+
+#if LOG_LEVEL > 0
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+
+#define LOG_RING_SIZE 4096  // 2'nin kuvveti
+#define LOG_TEXT 240        // Daha uzun satırlar kesilir
+#define LOG_FLUSH_MS 50     // Boşaltıcı en geç bu kadar sonra uyanır; halka yarılanınca hemen
+
+typedef struct {
+    _Atomic uint64_t seq;   // t + 1: t numaralı satır yazıldı, okunabilir
+    uint64_t time_ns;
+    int level;
+    int category;
+    char text[LOG_TEXT];
+} LogSlot;
+
+static LogSlot ring[LOG_RING_SIZE];
+static _Atomic uint64_t ring_head;  // Sıradaki yazarın numarası
+static _Atomic uint64_t ring_tail;  // Boşaltıcının okuyacağı sıradaki numara
+static _Atomic uint64_t dropped;    // Halka doluyken atılan satırlar
+static _Atomic uint32_t doorbell;   // Boşaltıcının futex'i
+
+static pthread_once_t setup_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t drain_lock = PTHREAD_MUTEX_INITIALIZER;
+static int max_level;
+static int categories = ~0;
+static int out_fd = STDERR_FILENO;
+static pid_t pid;
+static pthread_t flusher;
+static _Atomic int flusher_running;
+static _Atomic int stopping;
+
+static const char *const level_names[] = { "", "ERROR", "WARN", "INFO", "DEBUG" };
+static const struct {
+    const char *name;
+    int bit;
+} category_names[] = {
+    { "model", LOG_MODEL }, { "msg", LOG_MSG }, { "controller", LOG_CONTROLLER },
+    { "view", LOG_VIEW }, { "spawn", LOG_SPAWN },
+};
+#define CATEGORY_COUNT (sizeof(category_names) / sizeof(category_names[0]))
+
+static void write_all(const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(out_fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static const char *category_name(int category) {
+    for (size_t i = 0; i < CATEGORY_COUNT; i++) {
+        if (category_names[i].bit == category) return category_names[i].name;
+    }
+    return "?";
+}
+
+// Halkada yazılmış ne varsa tek write ile çıkar; yarım kalan yazarda durur
+static void drain(void) {
+    char batch[64 * 1024];
+    size_t len = 0;
+    pthread_mutex_lock(&drain_lock);
+    uint64_t t = atomic_load_explicit(&ring_tail, memory_order_relaxed);
+    for (;;) {
+        LogSlot *slot = &ring[t & (LOG_RING_SIZE - 1)];
+        if (atomic_load_explicit(&slot->seq, memory_order_acquire) != t + 1) break;
+        if (len + LOG_TEXT + 64 > sizeof(batch)) {
+            write_all(batch, len);
+            len = 0;
+        }
+        time_t sec = (time_t)(slot->time_ns / 1000000000ull);
+        struct tm tm;
+        localtime_r(&sec, &tm);
+        size_t text_len = strnlen(slot->text, LOG_TEXT);
+        while (text_len > 0 && slot->text[text_len - 1] == '\n') text_len--;
+        len += (size_t)snprintf(batch + len, sizeof(batch) - len, "%02d:%02d:%02d.%06llu %d %-5s %s: %.*s\n",
+                                tm.tm_hour, tm.tm_min, tm.tm_sec,
+                                (unsigned long long)(slot->time_ns % 1000000000ull / 1000), (int)pid,
+                                level_names[slot->level], category_name(slot->category), (int)text_len, slot->text);
+        // Satır kopyalandı, yuva yazarlara geri verilir
+        atomic_store_explicit(&ring_tail, ++t, memory_order_release);
+    }
+    uint64_t lost = atomic_exchange(&dropped, 0);
+    if (lost) len += (size_t)snprintf(batch + len, sizeof(batch) - len, "%d log: %llu lines dropped\n", (int)pid,
+                                      (unsigned long long)lost);
+    if (len) write_all(batch, len);
+    pthread_mutex_unlock(&drain_lock);
+}
+
+static void *flusher_main(void *arg) {
+    (void)arg;
+    struct timespec delay = { 0, LOG_FLUSH_MS * 1000000L };
+    while (!atomic_load(&stopping)) {
+        uint32_t seen = atomic_load(&doorbell);
+        syscall(SYS_futex, (uint32_t *)&doorbell, FUTEX_WAIT, seen, &delay, NULL, 0);
+        drain();
+    }
+    return NULL;
+}
+
+static void start_flusher(void) {
+    int expected = 0;
+    if (!atomic_compare_exchange_strong(&flusher_running, &expected, 1)) return;
+    // Sinyaller (SIGCHLD vb.) ana iş parçacığında kalsın
+    sigset_t all, old;
+    sigfillset(&all);
+    pthread_sigmask(SIG_SETMASK, &all, &old);
+    if (pthread_create(&flusher, NULL, flusher_main, NULL) != 0) atomic_store(&flusher_running, 0);
+    pthread_sigmask(SIG_SETMASK, &old, NULL);
+}
+
+static void log_shutdown(void) {
+    atomic_store(&stopping, 1);
+    atomic_fetch_add(&doorbell, 1);
+    syscall(SYS_futex, (uint32_t *)&doorbell, FUTEX_WAKE, 1, NULL, NULL, 0);
+    if (atomic_load(&flusher_running)) pthread_join(flusher, NULL);
+    atomic_store(&flusher_running, 0);
+    drain();
+}
+
+// Çatallanan çocukta iş parçacığı yoktur ve ebeveynin bekleyen satırları
+// ebeveynde yazılacaktır: halka boşaltılır, boşaltıcı ilk satırda yeniden başlar
+static void log_after_fork(void) {
+    pthread_mutex_init(&drain_lock, NULL);
+    atomic_store(&ring_tail, atomic_load(&ring_head));
+    atomic_store(&dropped, 0);
+    for (size_t i = 0; i < LOG_RING_SIZE; i++) atomic_store(&ring[i].seq, 0);
+    atomic_store(&flusher_running, 0);
+    pid = getpid();
+}
+
+// TERMINAL_LOG=seviye[:kategori,...] ör. "debug", "info:model,msg", "off"
+static void log_setup(void) {
+    max_level = LOG_LEVEL;
+    const char *spec = getenv("TERMINAL_LOG");
+    if (spec && spec[0]) {
+        size_t level_len = strcspn(spec, ":");
+        max_level = 0;
+        for (int i = 1; i <= LOG_LEVEL_DEBUG; i++) {
+            if (strlen(level_names[i]) == level_len && strncasecmp(spec, level_names[i], level_len) == 0) max_level = i;
+        }
+        if (spec[level_len] == ':') {
+            categories = 0;
+            const char *p = spec + level_len + 1;
+            while (*p) {
+                size_t n = strcspn(p, ",");
+                for (size_t i = 0; i < CATEGORY_COUNT; i++) {
+                    if (strlen(category_names[i].name) == n && strncmp(p, category_names[i].name, n) == 0) {
+                        categories |= category_names[i].bit;
+                    }
+                }
+                p += n + (p[n] == ',');
+            }
+        }
+    }
+    const char *path = getenv("TERMINAL_LOG_FILE");
+    if (path && path[0]) {
+        int fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd >= 0) out_fd = fd;
+        else perror("Failed to open log file");
+    }
+    pid = getpid();
+    atexit(log_shutdown);
+    pthread_atfork(NULL, NULL, log_after_fork);
+}
+
+int log_enabled(int level, int category) {
+    pthread_once(&setup_once, log_setup);
+    return level <= max_level && (category & categories);
+}
+
+void log_write(int level, int category, const char *fmt, ...) {
+    if (!atomic_load_explicit(&flusher_running, memory_order_relaxed)) start_flusher();
+
+    // Yer varsa bir numara al; boşaltıcı geride kaldıysa beklemeden satırı at
+    uint64_t t = atomic_load_explicit(&ring_head, memory_order_relaxed);
+    do {
+        if (t - atomic_load_explicit(&ring_tail, memory_order_acquire) >= LOG_RING_SIZE) {
+            atomic_fetch_add_explicit(&dropped, 1, memory_order_relaxed);
+            return;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&ring_head, &t, t + 1, memory_order_acq_rel,
+                                                    memory_order_relaxed));
+
+    LogSlot *slot = &ring[t & (LOG_RING_SIZE - 1)];
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    slot->time_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+    slot->level = level;
+    slot->category = category;
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(slot->text, LOG_TEXT, fmt, args);
+    va_end(args);
+    atomic_store_explicit(&slot->seq, t + 1, memory_order_release);
+
+    // Halkanın yarısını dolduran tek yazar boşaltıcıyı erken uyandırır
+    if (((t + 1) & (LOG_RING_SIZE / 2 - 1)) == 0) {
+        atomic_fetch_add(&doorbell, 1);
+        syscall(SYS_futex, (uint32_t *)&doorbell, FUTEX_WAKE, 1, NULL, NULL, 0);
+    }
+}
+
+void log_flush(void) {
+    drain();
+}
+#endif
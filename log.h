@@ -0,0 +1,61 @@
+#ifndef LOG_H
+#define LOG_H
+
+// Seviyeli ve kategorili hata ayıklama günlüğü. LOG_LEVEL derleme anında
+// verilir (make LOG_LEVEL=4); eşiğin üstündeki çağrılar hiç kod üretmez,
+// argümanları da değerlendirilmez. Açıkken satırlar kilitsiz bir halkaya
+// biçimlenir ve ayrı bir iş parçacığı onları toplu halde dosyaya yazar.
+#ifndef LOG_LEVEL
+#define LOG_LEVEL 0
+#endif
+
+#define LOG_LEVEL_ERROR 1
+#define LOG_LEVEL_WARN 2
+#define LOG_LEVEL_INFO 3
+#define LOG_LEVEL_DEBUG 4
+
+#define LOG_MODEL 1
+#define LOG_MSG 2
+#define LOG_CONTROLLER 4
+#define LOG_VIEW 8
+#define LOG_SPAWN 16
+
+#if LOG_LEVEL > 0
+void log_write(int level, int category, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+int log_enabled(int level, int category);
+void log_flush(void);
+#define LOG_AT(level, category, ...) \
+    do { if (log_enabled(level, category)) log_write(level, category, __VA_ARGS__); } while (0)
+#else
+static inline void log_flush(void) {}
+#endif
+
+// Kapalı seviyeler: biçim dizgesi yine denetlenir ama çağrı derleyicide silinir
+static inline __attribute__((format(printf, 1, 2))) void log_discard(const char *fmt, ...) { (void)fmt; }
+#define LOG_OFF(category, ...) do { if (0) log_discard(__VA_ARGS__); } while (0)
+
+#if LOG_LEVEL >= LOG_LEVEL_ERROR
+#define LOG_ERROR(category, ...) LOG_AT(LOG_LEVEL_ERROR, category, __VA_ARGS__)
+#else
+#define LOG_ERROR(category, ...) LOG_OFF(category, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_WARN
+#define LOG_WARN(category, ...) LOG_AT(LOG_LEVEL_WARN, category, __VA_ARGS__)
+#else
+#define LOG_WARN(category, ...) LOG_OFF(category, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_INFO
+#define LOG_INFO(category, ...) LOG_AT(LOG_LEVEL_INFO, category, __VA_ARGS__)
+#else
+#define LOG_INFO(category, ...) LOG_OFF(category, __VA_ARGS__)
+#endif
+
+#if LOG_LEVEL >= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(category, ...) LOG_AT(LOG_LEVEL_DEBUG, category, __VA_ARGS__)
+#else
+#define LOG_DEBUG(category, ...) LOG_OFF(category, __VA_ARGS__)
+#endif
+
+#endif
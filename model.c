@@ -1,213 +1,951 @@
+#define _GNU_SOURCE
+#include <errno.h>
 #include <fcntl.h>
+#include <sched.h>
+#include <signal.h>
+#include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <linux/futex.h>
+#include <sys/eventfd.h>
 #include <sys/mman.h>
+#include <sys/sendfile.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/wait.h>
 #include <unistd.h>
 #include <time.h>
 #include "model.h"
+#include "compress.h"
+#include "log.h"
+#include "msglog.h"
+#include "search.h"
 
 #define errExit(msg) do { perror(msg); exit(EXIT_FAILURE); } while (0)
 
+static int save_entry(const MessageEntry *entry, const char *path, int autosave, char *result, size_t result_size);
+static uint64_t checksum(const unsigned char *p, size_t len);
+static int replay_record(const LogRecord *record, void *data);
+static MsgLog *open_message_log(void);
+static History *open_history(void);
+
+// Dosya nesnesinin adı: oluşturan pid ve süreç içi sayaç
+static void blob_name(uint64_t blob, char *name, size_t size) {
+    snprintf(name, size, "%s.f%llx", SHARED_FILE_PATH, (unsigned long long)blob);
+}
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+// Segment MAP_SHARED olduğu için FUTEX_PRIVATE_FLAG kullanılmaz
+static void futex_wait(_Atomic uint32_t *addr, uint32_t expected) {
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAIT, expected, NULL, NULL, 0);
+}
+
+static void futex_wake_all(_Atomic uint32_t *addr) {
+    syscall(SYS_futex, (uint32_t *)addr, FUTEX_WAKE, INT32_MAX, NULL, NULL, 0);
+}
+
+// Yeni bir mesaj yayınlandığını bekleyen okuyuculara duyur
+static void notify_readers(ShmBuf *shm) {
+    atomic_fetch_add(&shm->notify, 1);
+    if (atomic_load(&shm->waiters) > 0) futex_wake_all(&shm->notify);
+}
+
+// futex'te bekleyip her değişiklikte eventfd'ye yazar; GLib ana döngüsü
+// eventfd'yi izler, böylece boşta hiçbir pencere uyanmaz
+static void *notify_thread_main(void *arg) {
+    Model *model = arg;
+    ShmBuf *shm = model->shmp;
+    uint32_t seen = atomic_load_explicit(&shm->notify, memory_order_acquire);
+
+    while (!atomic_load(&model->stopping)) {
+        atomic_fetch_add(&shm->waiters, 1);
+        uint32_t now = atomic_load(&shm->notify);
+        if (now == seen) futex_wait(&shm->notify, seen);
+        atomic_fetch_sub(&shm->waiters, 1);
+
+        now = atomic_load_explicit(&shm->notify, memory_order_acquire);
+        if (now == seen) continue;
+        seen = now;
+        uint64_t one = 1;
+        if (write(model->notify_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) perror("eventfd write");
+    }
+    return NULL;
+}
+
+static uint32_t round_pow2(uint32_t n) {
+    uint32_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// Açılışta günlüğün kuyruğunu dizine ekler. search_from yalnızca kesintisiz
+// numaralarla ilerler: eşzamanlı yazarlar günlüğe sırasız ekleyebildiği için
+// boşluktan sonrakiler halkadan yeniden okunur (dizin aynısını iki kez eklemez)
+static int index_log_record(const LogRecord *record, void *data) {
+    Model *model = data;
+    if (record->type == 0) search_add(model->search, record->seq, record->data, record->data_len);
+    else search_add(model->search, record->seq, record->name, record->name_len);
+    if (model->search_from == UINT64_MAX) model->search_start = model->search_from = record->seq;
+    if (record->seq == model->search_from) model->search_from++;
+    return 0;
+}
+
 Model *model_init(const char *username) {
     Model *model = malloc(sizeof(Model));
-    model->processes = NULL;
+    int capacity = MAX_PROCESSES;
+    const char *limit = getenv("TERMINAL_MAX_PROCESSES");
+    if (limit && atoi(limit) > 0) capacity = atoi(limit);
+    model->processes = calloc((size_t)capacity, sizeof(ProcessInfo));
+    if (!model->processes) errExit("calloc failed");
+    for (int i = 0; i < capacity; i++) model->processes[i].next_free = i + 1 < capacity ? i + 1 : -1;
+    model->process_capacity = capacity;
     model->process_count = 0;
-    model->cmd_count = 0;
+    model->process_free = 0;
+    model->history = open_history();
+    model->stats = stats_new();
     strncpy(model->username, username, MAX_USERNAME - 1);
     model->username[MAX_USERNAME - 1] = '\0';
 
-    int fd = shm_open(SHARED_FILE_PATH, O_CREAT | O_RDWR, 0600);
+    // O_EXCL ile oluşturan süreci belirle; yalnızca o boyutları yazar
+    int is_new = 1;
+    int fd = shm_open(SHARED_FILE_PATH, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0 && errno == EEXIST) {
+        is_new = 0;
+        fd = shm_open(SHARED_FILE_PATH, O_RDWR, 0600);
+    }
     if (fd < 0) errExit("shm_open failed");
 
-    struct stat shm_stat;
-    int is_new = (fstat(fd, &shm_stat) == 0 && shm_stat.st_size == 0);
-    if (is_new && ftruncate(fd, sizeof(ShmBuf)) == -1) errExit("ftruncate failed");
+    if (is_new) {
+        uint32_t slots = MSG_SLOTS;
+        const char *env = getenv("TERMINAL_MSG_SLOTS");
+        if (env && atoi(env) > 0) slots = (uint32_t)atoi(env);
+        slots = round_pow2(slots < 64 ? 64 : slots);
+        uint32_t arena_size = round_pow2(slots * MSG_ARENA_PER_SLOT);
+        if (arena_size < 4 * MAX_RECORD) arena_size = round_pow2(4 * MAX_RECORD);
 
-    model->shmp = mmap(NULL, sizeof(ShmBuf), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (model->shmp == MAP_FAILED) errExit("mmap failed");
+        model->shm_size = sizeof(ShmBuf) + slots * sizeof(MessageSlot) + arena_size;
+        if (ftruncate(fd, model->shm_size) == -1) errExit("ftruncate failed");
+        model->shmp = mmap(NULL, model->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (model->shmp == MAP_FAILED) errExit("mmap failed");
+        model->shmp->slot_count = slots;
+        model->shmp->arena_size = arena_size;
+        model->arena = (char *)&model->shmp->slots[slots];
+        model->log = open_message_log();
+        size_t replayed = model->log ? msglog_tail(model->log, slots, replay_record, model) : 0;
+        if (replayed) LOG_INFO(LOG_MODEL, "Replayed %zu messages from the log", replayed);
+        atomic_store_explicit(&model->shmp->ready, 1, memory_order_release);
+    } else {
+        // Önce yalnızca başlığı eşle, oluşturan hazır olunca boyutları oku
+        struct stat shm_stat;
+        while (fstat(fd, &shm_stat) == 0 && (size_t)shm_stat.st_size < sizeof(ShmBuf)) sched_yield();
+        ShmBuf *header = mmap(NULL, sizeof(ShmBuf), PROT_READ, MAP_SHARED, fd, 0);
+        if (header == MAP_FAILED) errExit("mmap failed");
+        while (!atomic_load_explicit(&header->ready, memory_order_acquire)) sched_yield();
+        model->shm_size = sizeof(ShmBuf) + header->slot_count * sizeof(MessageSlot) + header->arena_size;
+        munmap(header, sizeof(ShmBuf));
+        model->shmp = mmap(NULL, model->shm_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (model->shmp == MAP_FAILED) errExit("mmap failed");
+        model->log = open_message_log();
+    }
+    close(fd);
+    atomic_fetch_add(&model->shmp->attached, 1);
+    model->arena = (char *)&model->shmp->slots[model->shmp->slot_count];
+    model->scratch = malloc(MAX_RECORD + 2);
+    model->blob_counter = 0;
+    model->autosave_dir = NULL;
+    model->search = search_new();
+    // Geçmiş canlı okumadan önce, sırayla eklenir: kelime listeleri hep sona uzar.
+    // Yalnızca kuyruk okunur; açılış süresi ve bellek günlüğün boyuyla büyümez
+    model->search_start = 0;
+    model->search_from = UINT64_MAX;
+    if (model->log) msglog_tail(model->log, SEARCH_BACKFILL, index_log_record, model);
+    if (model->search_from == UINT64_MAX) model->search_from = 0;
 
-    model->shmp->fd = fd;
+    // Yeni okuyucu halkada hâlâ duran geçmişten başlar
+    uint64_t head = atomic_load_explicit(&model->shmp->head, memory_order_acquire);
+    model->read_cursor = head > model->shmp->slot_count ? head - model->shmp->slot_count : 0;
+
+    model->notify_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (model->notify_fd < 0) errExit("eventfd failed");
+    atomic_init(&model->stopping, 0);
+    if (pthread_create(&model->notify_thread, NULL, notify_thread_main, model) != 0) errExit("pthread_create failed");
 
     if (is_new) {
-        model->shmp->cnt = 0;
-        model->shmp->msg_index = 0;
-        sem_init(&model->shmp->sem, 1, 1);
-        printf("Initialized new shared memory for %s: cnt=%zu, msg_index=%d\n", username, model->shmp->cnt, model->shmp->msg_index);
+        LOG_INFO(LOG_MODEL, "Initialized new shared memory for %s: %u slots, %u byte arena", username,
+                 model->shmp->slot_count, model->shmp->arena_size);
     } else {
-        printf("Attached to existing shared memory for %s: cnt=%zu, msg_index=%d\n", username, model->shmp->cnt, model->shmp->msg_index);
+        LOG_INFO(LOG_MODEL, "Attached to existing shared memory for %s: head=%llu", username, (unsigned long long)head);
     }
 
     return model;
 }
 
 void model_destroy(Model *model) {
+    // Panolar için: her pencere kendi histogramlarını TERMINAL_STATS_DIR'e bırakır
+    const char *stats_dir = getenv("TERMINAL_STATS_DIR");
+    if (stats_dir && stats_dir[0]) {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/stats-%s.json", stats_dir, model->username);
+        if (model_export_stats(model, path) == -1) perror("Failed to export stats");
+    }
+
+    // Bekleyen iş parçacığını uyandırıp durdur (diğer okuyucular boş bir uyanış görür)
+    atomic_store(&model->stopping, 1);
+    notify_readers(model->shmp);
+    pthread_join(model->notify_thread, NULL);
+    close(model->notify_fd);
+
     if (model->shmp) {
-        if (strcmp(model->username, "User1") == 0) {
-            sem_destroy(&model->shmp->sem);
-            munmap(model->shmp, sizeof(ShmBuf));
+        // Hangi pencere en son kapanırsa segmenti ve dosya nesnelerini o siler
+        if (atomic_fetch_sub(&model->shmp->attached, 1) == 1) {
+            for (uint32_t i = 0; i < model->shmp->slot_count; i++) {
+                uint64_t blob = model->shmp->slots[i].blob;
+                if (!blob) continue;
+                char name[MAX_FILE_BLOB];
+                blob_name(blob, name, sizeof(name));
+                shm_unlink(name);
+            }
+            munmap(model->shmp, model->shm_size);
             shm_unlink(SHARED_FILE_PATH);
-            printf("Destroyed shared memory by %s\n", model->username);
+            LOG_INFO(LOG_MODEL, "Destroyed shared memory by %s", model->username);
         } else {
-            munmap(model->shmp, sizeof(ShmBuf));
-            printf("Detached shared memory by %s\n", model->username);
+            munmap(model->shmp, model->shm_size);
+            LOG_INFO(LOG_MODEL, "Detached shared memory by %s", model->username);
         }
     }
+    msglog_close(model->log);
+    search_free(model->search);
+    history_free(model->history);
+    free(model->scratch);
+    free(model->autosave_dir);
     free(model->processes);
+    stats_free(model->stats);
     free(model);
 }
 
-void model_execute_command(Model *model, const char *command, char *output, size_t output_size) {
+// Süreci spawn katmanıyla başlatır ve süreç tablosuna kaydeder.
+// Tablo doluysa hiç başlatmaz: -1 döner, errno EAGAIN olur.
+pid_t model_spawn_command(Model *model, const char *command, const SpawnRequest *req) {
+    if (model->process_free < 0) {
+        errno = EAGAIN;
+        return -1;
+    }
+    uint64_t started = now_ns();
+    pid_t pid = spawn_process(req);
+    if (pid < 0) return -1;
+
+    ProcessInfo *p = &model->processes[model->process_free];
+    model->process_free = p->next_free;
+    model->process_count++;
+    p->pid = pid;
+    strncpy(p->command, command, MAX_COMMAND - 1);
+    p->command[MAX_COMMAND - 1] = '\0';
+    p->status = 0;
+    p->started = started;
+    p->spawned = now_ns();
+    p->first_byte = p->eof = p->exited = p->rendered = 0;
+    p->has_usage = 0;
+    return pid;
+}
+
+static ProcessInfo *find_process(Model *model, pid_t pid) {
+    if (pid <= 0) return NULL;
+    for (int i = 0; i < model->process_capacity; i++) {
+        if (model->processes[i].pid == pid) return &model->processes[i];
+    }
+    return NULL;
+}
+
+// Her olay yalnızca ilk kez damgalanır
+void model_process_event(Model *model, pid_t pid, ProcessEvent event) {
+    ProcessInfo *p = find_process(model, pid);
+    if (!p) return;
+    uint64_t *stamp = event == PROCESS_FIRST_BYTE ? &p->first_byte : event == PROCESS_EOF ? &p->eof : &p->rendered;
+    if (!*stamp) *stamp = now_ns();
+}
+
+void model_process_exited(Model *model, pid_t pid, int status, const struct rusage *usage) {
+    ProcessInfo *p = find_process(model, pid);
+    if (!p) return;
+    p->status = status;
+    p->exited = now_ns();
+    if (usage) {
+        p->usage = *usage;
+        p->has_usage = 1;
+    }
+}
+
+static uint64_t timeval_ns(struct timeval tv) {
+    return (uint64_t)tv.tv_sec * 1000000000ull + (uint64_t)tv.tv_usec * 1000ull;
+}
+
+// Sürecin ölçümlerini histogramlara ekler ve yuvasını boş listeye geri verir
+void model_process_finished(Model *model, pid_t pid) {
+    ProcessInfo *p = find_process(model, pid);
+    if (!p) return;
+    Stats *stats = model->stats;
+    uint64_t last = p->exited > p->rendered ? p->exited : p->rendered;
+    stats_count_process(stats);
+    stats_record(stats, STAT_SPAWN, p->spawned - p->started);
+    if (p->first_byte) stats_record(stats, STAT_FIRST_BYTE, p->first_byte - p->spawned);
+    if (p->first_byte && p->eof) stats_record(stats, STAT_READ, p->eof - p->first_byte);
+    if (p->exited) stats_record(stats, STAT_RUNTIME, p->exited - p->spawned);
+    if (p->eof && p->rendered) stats_record(stats, STAT_RENDER, p->rendered - p->eof);
+    if (last) stats_record(stats, STAT_TOTAL, last - p->started);
+    if (p->has_usage) {
+        stats_record(stats, STAT_CPU_USER, timeval_ns(p->usage.ru_utime));
+        stats_record(stats, STAT_CPU_SYS, timeval_ns(p->usage.ru_stime));
+        stats_record(stats, STAT_MAX_RSS, (uint64_t)p->usage.ru_maxrss);
+    }
+    p->pid = 0;
+    p->next_free = model->process_free;
+    model->process_free = (int)(p - model->processes);
+    model->process_count--;
+}
+
+int model_export_stats(Model *model, const char *path) {
+    return stats_export(model->stats, path);
+}
+
+void model_add_history(Model *model, const char *command) {
+    // Halkaya ekle; dosyaya tampon dolunca ya da çıkışta yazılır
+    if (model->history) history_add(model->history, command);
+}
+
+int model_execute_command(Model *model, const char *command, OutputCallback on_output, void *data) {
     int pipefd[2];
-    if (pipe(pipefd) == -1) {
+    if (pipe2(pipefd, O_CLOEXEC) == -1) {
         perror("pipe failed");
-        return;
-    }
-
-    pid_t pid = fork();
-    if (pid == 0) { // Child
-        close(pipefd[0]); // Close read end
-        dup2(pipefd[1], STDOUT_FILENO); // Redirect stdout to pipe
-        dup2(pipefd[1], STDERR_FILENO); // Redirect stderr to pipe
-        close(pipefd[1]);
-
-        // Run the command through the shell to handle redirection
-        // Yönlendirme işlemini shell'e bırakıyoruz, bu yüzden burada ek bir işlem yapmıyoruz
-        execlp("sh", "sh", "-c", command, (char *)NULL);
-        perror("execlp failed");
-        exit(EXIT_FAILURE);
-    } else if (pid > 0) { // Parent
-        close(pipefd[1]); // Close write end
-        char buffer[BUF_SIZE] = {0};
-        ssize_t n = read(pipefd[0], buffer, output_size - 1);
-        if (n > 0) {
-            buffer[n] = '\0';
-            strncpy(output, buffer, output_size - 1);
-            fprintf(stderr, "Model execute output: %s\n", output); // Debug için stderr'a yaz
-        } else {
-            output[0] = '\0';
-            fprintf(stderr, "Model execute: No output\n"); // Debug için stderr'a yaz
-        }
+        return -1;
+    }
+
+    // Run the command through the shell to handle redirection
+    // Yönlendirme işlemini shell'e bırakıyoruz, bu yüzden burada ek bir işlem yapmıyoruz
+    SpawnRequest req;
+    spawn_request_init(&req);
+    req.shell_command = command;
+    req.stdout_fd = pipefd[1]; // Redirect stdout to pipe
+    req.stderr_fd = pipefd[1]; // Redirect stderr to pipe
+
+    pid_t pid = model_spawn_command(model, command, &req);
+    close(pipefd[1]); // Close write end
+    if (pid < 0) {
+        perror("spawn failed");
         close(pipefd[0]);
+        return -1;
+    }
 
-        // Update command history and process tracking
-        model->processes = realloc(model->processes, sizeof(ProcessInfo) * (model->process_count + 1));
-        ProcessInfo *p = &model->processes[model->process_count++];
-        p->pid = pid;
-        strncpy(p->command, command, MAX_COMMAND);
-        p->status = 0;
-
-        // Sürecin tamamlanmasını bekle
-        int status;
-        waitpid(pid, &status, 0);
-        p->status = 1;
-
-        // Komut geçmişini güncelle
-        if (model->cmd_count < MAX_HISTORY) {
-            strncpy(model->command_history[model->cmd_count++], command, MAX_COMMAND);
-        } else {
-            memmove(model->command_history[0], model->command_history[1], (MAX_HISTORY - 1) * MAX_COMMAND);
-            strncpy(model->command_history[MAX_HISTORY - 1], command, MAX_COMMAND);
+    // Çıktıyı EOF'a kadar parça parça oku ve her parçayı hemen ilet
+    char buffer[BUF_SIZE];
+    size_t total = 0;
+    for (;;) {
+        ssize_t n = read(pipefd[0], buffer, sizeof(buffer));
+        if (n == 0) break;
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("read failed");
+            break;
         }
+        if (total == 0) model_process_event(model, pid, PROCESS_FIRST_BYTE);
+        if (on_output) on_output(buffer, (size_t)n, data);
+        total += (size_t)n;
+    }
+    close(pipefd[0]);
+    // Geri çağrı çıktıyı eşzamanlı tükettiği için EOF aynı zamanda gösterim anı
+    model_process_event(model, pid, PROCESS_EOF);
+    model_process_event(model, pid, PROCESS_RENDERED);
+    LOG_DEBUG(LOG_SPAWN, "Model execute: %zu bytes streamed", total);
+
+    // Sürecin tamamlanmasını bekle (EOF'tan sonra, böylece çocuk pipe'ta takılmaz)
+    int status = 0;
+    struct rusage usage;
+    pid_t reaped;
+    while ((reaped = wait4(pid, &status, 0, &usage)) == -1 && errno == EINTR) {}
+    model_process_exited(model, pid, status, reaped == pid ? &usage : NULL);
+    model_process_finished(model, pid);
+    // Geçmişe yazmak çağıranın işi; ölçümler kalıcı geçmişi kirletmesin
+    return status;
+}
+
+// Yuvayı yazan süreç hâlâ var mı. pid henüz yazılmadıysa (0) canlı sayılır;
+// pid başka bir sürece geçtiyse de beklemeye devam edilir, yanlış devralma olmaz
+static int writer_alive(MessageSlot *slot) {
+    pid_t writer = atomic_load_explicit(&slot->writer, memory_order_relaxed);
+    return writer == 0 || kill(writer, 0) == 0 || errno != ESRCH;
+}
+
+// Yazar için bir numara al ve yuvasını sahiplen. Aynı yuvaya daha yeni bir
+// numara zaten yazılmışsa (halka bizi geçti) NULL döner ve mesaj düşer.
+// Yuvada bir tur önceki yazar hâlâ çalışıyorsa bitirmesi beklenir: yavaş
+// ya da durdurulmuş bir yazar, halka onu geçene kadar tüm okuyucuların
+// imlecini de o mesajda tutar. Yuva yalnızca yazan süreç ölmüşse devralınır.
+static MessageSlot *slot_claim(ShmBuf *shm, uint64_t *ticket) {
+    uint64_t t = atomic_fetch_add_explicit(&shm->head, 1, memory_order_relaxed);
+    MessageSlot *slot = &shm->slots[t & (shm->slot_count - 1)];
+    uint64_t writing = 2 * t + 1;
+    int spins = 0;
 
-        // Debug: Komut geçmişini yazdır
-        fprintf(stderr, "Command history updated:\n"); // Debug için stderr'a yaz
-        for (int i = 0; i < model->cmd_count; i++) {
-            fprintf(stderr, "  [%d]: %s\n", i, model->command_history[i]); // Debug için stderr'a yaz
+    for (;;) {
+        uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if (seq > writing) return NULL;
+        if (seq & 1) {
+            // Önce kısa süre dön, sonra uyuyarak bekle; ölüm yalnızca arada bir denetlenir
+            if (++spins < 100) {
+                sched_yield();
+                continue;
+            }
+            if (spins % 100 != 0 || writer_alive(slot)) {
+                struct timespec delay = { 0, 100000 };
+                nanosleep(&delay, NULL);
+                continue;
+            }
+            LOG_WARN(LOG_MSG, "Taking over slot %llu from dead writer %d", (unsigned long long)(seq / 2),
+                     (int)atomic_load(&slot->writer));
+        }
+        // Numara değişmediyse yazar da aynıdır: CAS, arada yayınlayan bir yazarı ezmez
+        if (atomic_compare_exchange_weak_explicit(&slot->seq, &seq, writing,
+                                                  memory_order_acquire, memory_order_relaxed)) {
+            atomic_store_explicit(&slot->writer, getpid(), memory_order_relaxed);
+            // Üzerine yazılan dosya mesajının içeriğini serbest bırak
+            if (slot->blob) {
+                char name[MAX_FILE_BLOB];
+                blob_name(slot->blob, name, sizeof(name));
+                shm_unlink(name);
+                slot->blob = 0;
+            }
+            break;
         }
-    } else {
-        perror("fork failed");
     }
+    *ticket = t;
+    return slot;
+}
+
+static void slot_publish(MessageSlot *slot, uint64_t ticket) {
+    atomic_store_explicit(&slot->writer, 0, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, 2 * ticket + 2, memory_order_release);
+}
+
+// Halkanın sonunu aşan kopyalar başa sarar
+static void arena_write(Model *model, uint64_t pos, const void *src, size_t len) {
+    if (len == 0) return;
+    uint32_t size = model->shmp->arena_size;
+    size_t at = pos & (size - 1);
+    size_t first = len < size - at ? len : size - at;
+    memcpy(model->arena + at, src, first);
+    memcpy(model->arena, (const char *)src + first, len - first);
+}
+
+static void arena_read(Model *model, uint64_t pos, void *dst, size_t len) {
+    uint32_t size = model->shmp->arena_size;
+    size_t at = pos & (size - 1);
+    size_t first = len < size - at ? len : size - at;
+    memcpy(dst, model->arena + at, first);
+    memcpy((char *)dst + first, model->arena, len - first);
 }
 
-void model_send_message(Model *model, const char *message) {
-    sem_wait(&model->shmp->sem);
-    int idx = model->shmp->msg_index % MAX_HISTORY;
+// Yuvanın içeriğini ve arena kaydını yazıp yayınlar
+static void fill_slot(Model *model, MessageSlot *slot, uint64_t ticket, const char *sender, time_t timestamp,
+                      int type, const char *name, size_t name_len, const char *data, size_t data_len,
+                      uint64_t blob, uint64_t file_size) {
+    ShmBuf *shm = model->shmp;
+    RecordHeader rec = { (uint32_t)name_len, (uint32_t)data_len };
+    uint32_t length = sizeof(rec) + name_len + data_len;
+    // acq_rel: veri yazımları yer ayrılmadan önceye kaymaz
+    uint64_t offset = atomic_fetch_add_explicit(&shm->arena_tail, length, memory_order_acq_rel);
+    arena_write(model, offset, &rec, sizeof(rec));
+    arena_write(model, offset + sizeof(rec), name, name_len);
+    arena_write(model, offset + sizeof(rec) + name_len, data, data_len);
 
-    // Zaman damgası ekle
+    slot->offset = offset;
+    slot->length = length;
+    slot->timestamp = timestamp;
+    slot->type = type;
+    slot->blob = blob;
+    slot->file_size = file_size;
+    strncpy(slot->sender, sender, MAX_USERNAME - 1);
+    slot->sender[MAX_USERNAME - 1] = '\0';
+    slot_publish(slot, ticket);
+}
+
+// Başarılıysa mesaj numarasını, halka bizi geçtiyse -1 (errno = EAGAIN) döndürür
+static int64_t publish_record(Model *model, int type, const char *name, size_t name_len,
+                              const char *data, size_t data_len, uint64_t blob, uint64_t file_size) {
+    uint64_t ticket;
+    MessageSlot *slot = slot_claim(model->shmp, &ticket);
+    if (!slot) {
+        LOG_WARN(LOG_MSG, "Message dropped: ring slot was overtaken");
+        errno = EAGAIN;
+        return -1;
+    }
     time_t now = time(NULL);
-    char timestamp[32];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&now));
+    fill_slot(model, slot, ticket, model->username, now, type, name, name_len, data, data_len, blob, file_size);
+    notify_readers(model->shmp);
+
+    // Kalıcı günlüğe de ekle (halka numarası günlükte de sıra numarasıdır)
+    if (model->log) {
+        LogRecord record = { ticket, now, type, model->username, name, (uint32_t)name_len,
+                             data, (uint32_t)data_len, file_size };
+        if (msglog_append(model->log, &record) == -1) perror("Failed to append to message log");
+    }
+    return (int64_t)ticket;
+}
 
-    char full_message[BUF_SIZE];
-    snprintf(full_message, sizeof(full_message), "[%s] %s", timestamp, message);
+// Mesaj halkaya yazılamadıysa -1 (errno = EAGAIN) döndürür
+int model_send_message(Model *model, const char *message) {
+    size_t len = strnlen(message, BUF_SIZE - 1);
+    int64_t seq = publish_record(model, 0, NULL, 0, message, len, 0, 0);
+    if (seq < 0) return -1;
+    LOG_DEBUG(LOG_MSG, "Sent message: [%s] %s (seq: %lld)", model->username, message, (long long)seq);
+    return 0;
+}
 
-    strncpy(model->shmp->messages[idx].sender, model->username, MAX_USERNAME);
-    model->shmp->messages[idx].type = 0;
-    strncpy(model->shmp->messages[idx].data, full_message, MAX_FILE_SIZE);
-    model->shmp->messages[idx].data_size = strlen(full_message) + 1;
-    model->shmp->msg_index++;
-    model->shmp->cnt = (model->shmp->cnt < MAX_HISTORY) ? model->shmp->cnt + 1 : MAX_HISTORY;
-    printf("Sent message: [%s] %s (index: %d, cnt: %zu)\n", model->username, full_message, idx, model->shmp->cnt);
-    sem_post(&model->shmp->sem);
+// Yeni segmenti oluşturan süreç günlüğün kuyruğunu halkaya geri yükler
+static int replay_record(const LogRecord *record, void *data) {
+    Model *model = data;
+    if (record->name_len >= MAX_COMMAND || record->data_len > BUF_SIZE) return 0;
+    MessageSlot *slot = &model->shmp->slots[record->seq & (model->shmp->slot_count - 1)];
+    // Dosya nesneleri önceki oturumla birlikte silindi: yalnızca kaydı kalır
+    fill_slot(model, slot, record->seq, record->sender, (time_t)record->timestamp, record->type,
+              record->name, record->name_len, record->data, record->data_len, 0, record->file_size);
+    uint64_t head = atomic_load_explicit(&model->shmp->head, memory_order_relaxed);
+    if (record->seq + 1 > head) atomic_store_explicit(&model->shmp->head, record->seq + 1, memory_order_release);
+    return 0;
 }
 
-void model_send_file(Model *model, const char *filename) {
-    sem_wait(&model->shmp->sem);
-    int idx = model->shmp->msg_index % MAX_HISTORY;
+static MsgLog *open_message_log(void) {
+    const char *path = getenv("TERMINAL_MSG_LOG");
+    char default_path[4096];
+    if (!path) {
+        const char *home = getenv("HOME");
+        snprintf(default_path, sizeof(default_path), "%s/.terminal_messages.log", home ? home : ".");
+        path = default_path;
+    }
+    if (!path[0]) return NULL; // Boş değer günlüğü kapatır
+    return msglog_open(path);
+}
 
-    int fd = open(filename, O_RDONLY);
+static History *open_history(void) {
+    size_t size = HISTORY_SIZE;
+    const char *env = getenv("TERMINAL_HISTORY_SIZE");
+    if (env && atol(env) > 0) size = (size_t)atol(env);
+    const char *path = getenv("TERMINAL_HISTORY_FILE");
+    char default_path[4096];
+    if (!path) {
+        const char *home = getenv("HOME");
+        snprintf(default_path, sizeof(default_path), "%s/.terminal_history", home ? home : ".");
+        path = default_path;
+    }
+    return history_new(size, path); // Boş yol yalnızca bellekte tutar
+}
+
+// Kaynağı hedefe parça parça kopyalar; mümkünse sendfile ile çekirdek içinde
+static int copy_file(int out_fd, int in_fd, uint64_t size) {
+    uint64_t done = 0;
+    while (done < size) {
+        size_t chunk = size - done > (1 << 20) ? (1 << 20) : (size_t)(size - done);
+        ssize_t n = sendfile(out_fd, in_fd, NULL, chunk);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && (errno == EINVAL || errno == ENOSYS)) {
+            // sendfile desteklenmiyor: düz read/write
+            char buffer[BUF_SIZE * 16];
+            n = read(in_fd, buffer, sizeof(buffer));
+            if (n > 0 && write(out_fd, buffer, n) != n) return -1;
+        }
+        if (n < 0) return -1;
+        if (n == 0) break; // Dosya biz okurken kısaldı
+        done += (uint64_t)n;
+    }
+    return done == size ? 0 : -1;
+}
+
+// Kaynağı eşleyip sıkıştırır; kazanç yoksa NULL döner ve dosya düz gönderilir
+static unsigned char *compress_file(int fd, uint64_t size, size_t *compressed_size) {
+    if (size == 0 || size >= UINT32_MAX) return NULL; // Karma tablosu 32 bit konum tutar
+    void *src = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (src == MAP_FAILED) return NULL;
+    size_t capacity = lz_compress_bound(size);
+    unsigned char *buffer = malloc(capacity);
+    size_t len = buffer ? lz_compress(src, size, buffer, capacity) : 0;
+    munmap(src, size);
+    if (len == 0 || len >= size) {
+        free(buffer);
+        return NULL;
+    }
+    *compressed_size = len;
+    return buffer;
+}
+
+static int write_all(int fd, const unsigned char *data, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        ssize_t n = write(fd, data + done, len - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        done += (size_t)n;
+    }
+    return 0;
+}
+
+// Dosyanın tamamını ayrı bir shm nesnesine kopyalar ve mesajda yalnızca adını
+// yayınlar. Disk okuması halkaya dokunmadan önce biter, boyut sınırı yoktur.
+// compress verilirse içerik sıkıştırılmış saklanır, alıcı kaydederken açar.
+// Hata -1 döndürür; errno EAGAIN ise mesaj halka dolu olduğu için düştü.
+int model_send_file(Model *model, const char *filename, int compress) {
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
     if (fd < 0) {
         perror("Failed to open file");
-        sem_post(&model->shmp->sem);
-        return;
+        return -1;
+    }
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1 || !S_ISREG(file_stat.st_mode)) {
+        fprintf(stderr, "Failed to send file: %s is not a regular file\n", filename);
+        close(fd);
+        return -1;
+    }
+    uint64_t size = (uint64_t)file_stat.st_size;
+
+    uint64_t blob = ((uint64_t)getpid() << 32) | ++model->blob_counter;
+    char name[MAX_FILE_BLOB];
+    blob_name(blob, name, sizeof(name));
+    int blob_fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (blob_fd < 0) {
+        perror("Failed to create file object");
+        close(fd);
+        return -1;
     }
-    ssize_t bytes_read = read(fd, model->shmp->messages[idx].data, MAX_FILE_SIZE - 1);
-    if (bytes_read < 0) {
-        perror("Failed to read file");
+
+    // Alıcının doğrulayacağı sağlama toplamı saklanan baytlar üzerinden hesaplanır
+    FileInfo info = { checksum(NULL, 0), size, 0, 0 };
+    size_t compressed_size = 0;
+    unsigned char *compressed = compress ? compress_file(fd, size, &compressed_size) : NULL;
+    if (compressed) {
+        info.flags |= FILE_COMPRESSED;
+        info.stored_size = compressed_size;
+        info.checksum = checksum(compressed, compressed_size);
+        int failed = ftruncate(blob_fd, compressed_size) == -1 || write_all(blob_fd, compressed, compressed_size) == -1;
+        free(compressed);
+        if (failed) {
+            perror("Failed to copy file");
+            close(blob_fd);
+            close(fd);
+            shm_unlink(name);
+            return -1;
+        }
+    } else if (ftruncate(blob_fd, size) == -1 || copy_file(blob_fd, fd, size) == -1) {
+        perror("Failed to copy file");
+        close(blob_fd);
         close(fd);
-        sem_post(&model->shmp->sem);
-        return;
+        shm_unlink(name);
+        return -1;
     }
-    model->shmp->messages[idx].data[bytes_read] = '\0';
     close(fd);
+    // Yayınlandıktan sonra içerik değişmesin
+    fchmod(blob_fd, 0400);
 
-    strncpy(model->shmp->messages[idx].sender, model->username, MAX_USERNAME);
-    model->shmp->messages[idx].type = 1;
-    strncpy(model->shmp->messages[idx].filename, filename, MAX_COMMAND);
-    model->shmp->messages[idx].data_size = bytes_read;
-    model->shmp->msg_index++;
-    model->shmp->cnt = (model->shmp->cnt < MAX_HISTORY) ? model->shmp->cnt + 1 : MAX_HISTORY;
-    printf("Sent file: [%s] %s (%zu bytes, index: %d, cnt: %zu)\n", model->username, filename, bytes_read, idx, model->shmp->cnt);
-    sem_post(&model->shmp->sem);
-}
-
-void model_read_messages(Model *model, char *buffer, size_t buffer_size) {
-    static char last_buffer[BUF_SIZE * MAX_HISTORY] = {0};
-    sem_wait(&model->shmp->sem);
-    buffer[0] = '\0';
-    size_t offset = 0;
-    for (int i = 0; i < model->shmp->cnt; i++) {
-        int idx = (model->shmp->msg_index - model->shmp->cnt + i) % MAX_HISTORY;
-        if (idx < 0) idx += MAX_HISTORY;
-        char line[BUF_SIZE + MAX_USERNAME + MAX_COMMAND + 20];
-        if (model->shmp->messages[idx].type == 0) {
-            char timestamp[32];
-            char content[BUF_SIZE];
-            if (sscanf(model->shmp->messages[idx].data, "[%[^]]] %[^\n]", timestamp, content) == 2) {
-                snprintf(line, sizeof(line), "[%s] [%s] %s\n", 
-                         model->shmp->messages[idx].sender, timestamp, content);
-            } else {
-                snprintf(line, sizeof(line), "[%s] %.*s\n", 
-                         model->shmp->messages[idx].sender, 
-                         (int)(sizeof(line) - MAX_USERNAME - 5), 
-                         model->shmp->messages[idx].data);
-            }
+    if (!compressed && size > 0) {
+        void *map = mmap(NULL, size, PROT_READ, MAP_SHARED, blob_fd, 0);
+        if (map == MAP_FAILED) {
+            perror("Failed to map file object");
+            close(blob_fd);
+            shm_unlink(name);
+            return -1;
+        }
+        info.checksum = checksum(map, size);
+        munmap(map, size);
+    }
+    close(blob_fd);
+
+    size_t name_len = strnlen(filename, MAX_COMMAND - 1);
+    int64_t seq = publish_record(model, 1, filename, name_len, (const char *)&info, sizeof(info), blob, size);
+    if (seq < 0) {
+        shm_unlink(name);
+        errno = EAGAIN;
+        return -1;
+    }
+    LOG_DEBUG(LOG_MSG, "Sent file: [%s] %s (%llu bytes, %llu stored, seq: %lld)", model->username, filename,
+              (unsigned long long)size, (unsigned long long)info.stored_size, (long long)seq);
+    return 0;
+}
+
+// c numaralı mesajı seqlock ile kopyalar: 1 = okundu, 0 = henüz yayınlanmadı,
+// -1 = üzerine yazıldı. filename ve data modelin scratch tamponunu gösterir.
+static int read_slot(Model *model, uint64_t c, MessageEntry *entry) {
+    ShmBuf *shm = model->shmp;
+    MessageSlot *slot = &shm->slots[c & (shm->slot_count - 1)];
+    uint64_t seq = atomic_load_explicit(&slot->seq, memory_order_acquire);
+    if (seq < 2 * c + 2) return 0;
+    if (seq > 2 * c + 2) return -1;
+
+    entry->seq = c;
+    entry->timestamp = slot->timestamp;
+    entry->type = slot->type;
+    uint64_t blob = slot->blob;
+    entry->file_size = slot->file_size;
+    memcpy(entry->sender, slot->sender, MAX_USERNAME);
+    uint64_t offset = slot->offset;
+    uint32_t length = slot->length;
+    if (length < sizeof(RecordHeader) || length > MAX_RECORD) return -1;
+
+    RecordHeader rec;
+    arena_read(model, offset, &rec, sizeof(rec));
+    if (rec.name_len >= MAX_COMMAND || rec.data_len > BUF_SIZE ||
+        sizeof(rec) + rec.name_len + rec.data_len != length) return -1;
+    char *name = model->scratch;
+    char *body = model->scratch + rec.name_len + 1;
+    arena_read(model, offset + sizeof(rec), name, rec.name_len);
+    arena_read(model, offset + sizeof(rec) + rec.name_len, body, rec.data_len);
+
+    // Kopyalarken yuva ya da arena baytları yeniden kullanıldıysa at
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&slot->seq, memory_order_relaxed) != seq) return -1;
+    if (atomic_load_explicit(&shm->arena_tail, memory_order_relaxed) - offset > shm->arena_size) return -1;
+
+    name[rec.name_len] = '\0';
+    body[rec.data_len] = '\0';
+    entry->sender[MAX_USERNAME - 1] = '\0';
+    entry->filename = name;
+    entry->data = body;
+    entry->data_size = rec.data_len;
+    entry->checksum = 0;
+    entry->stored_size = 0;
+    entry->compressed = 0;
+    entry->blob[0] = '\0';
+    if (entry->type == 1) {
+        FileInfo info;
+        if (rec.data_len != sizeof(info)) return -1;
+        memcpy(&info, body, sizeof(info));
+        entry->checksum = info.checksum;
+        entry->stored_size = info.stored_size;
+        entry->compressed = (info.flags & FILE_COMPRESSED) != 0;
+        // Günlükten geri yüklenen dosyaların içeriği artık yok (blob 0)
+        if (blob) blob_name(blob, entry->blob, sizeof(entry->blob));
+    }
+    return 1;
+}
+
+// Bu okuyucunun imlecinden itibaren yalnızca yeni mesajları sırayla iletir ve
+// iletilen mesaj sayısını döndürür. Hiç kilit almaz; yazılmakta olan bir
+// mesaja gelince durur, bir sonraki çağrıda oradan devam eder.
+int model_read_messages(Model *model, MessageCallback on_message, void *data) {
+    ShmBuf *shm = model->shmp;
+    uint64_t head = atomic_load_explicit(&shm->head, memory_order_acquire);
+    int delivered = 0;
+
+    // Halka bizi geçtiyse kaybolan mesajları atla
+    if (head - model->read_cursor > shm->slot_count) model->read_cursor = head - shm->slot_count;
+
+    while (model->read_cursor < head) {
+        MessageEntry entry;
+        int state = read_slot(model, model->read_cursor, &entry);
+        if (state == 0) break; // Henüz yayınlanmadı
+        model->read_cursor++;
+        if (state < 0) continue;
+
+        // Arama dizinine ekle: metin mesajlarında içerik, dosyalarda dosya adı.
+        // Halkadaki geçmişin günlükte olanı açılışta eklendi
+        if (entry.seq < model->search_start || entry.seq >= model->search_from) {
+            if (entry.type == 0) search_add(model->search, entry.seq, entry.data, entry.data_size);
+            else search_add(model->search, entry.seq, entry.filename, strlen(entry.filename));
+        }
+
+        if (on_message) on_message(&entry, data);
+        delivered++;
+
+        // Otomatik kaydetme: başkasından gelen dosyaları hemen diske yaz
+        if (entry.type == 1 && model->autosave_dir && strcmp(entry.sender, model->username) != 0) {
+            char result[BUF_SIZE];
+            save_entry(&entry, model->autosave_dir, 1, result, sizeof(result));
+            LOG_INFO(LOG_MSG, "Autosave: %s", result);
+        }
+    }
+    return delivered;
+}
+
+// FNV-1a 64, bayt yerine 8 baytlık kelimeler üzerinden (iki taraf da aynısını kullanır)
+static uint64_t checksum(const unsigned char *p, size_t len) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        uint64_t word;
+        memcpy(&word, p + i, 8);
+        hash = (hash ^ word) * 0x100000001b3ULL;
+    }
+    for (; i < len; i++) hash = (hash ^ p[i]) * 0x100000001b3ULL;
+    return hash;
+}
+
+// Dosya nesnesini eşler, sağlama toplamını doğrular ve tek bir write ile
+// doğrudan eşlemeden hedefe yazar. path bir dizinse gönderenin dosya adı eklenir.
+// autosave verilirse ad gönderenden geldiği için denetlenir ve var olan dosyanın
+// üzerine yazılmaz; çakışmada ada .1, .2, ... eklenir.
+static int save_entry(const MessageEntry *entry, const char *path, int autosave, char *result, size_t result_size) {
+    const char *base = strrchr(entry->filename, '/');
+    base = base ? base + 1 : entry->filename;
+    if (autosave && (base[0] == '\0' || strcmp(base, ".") == 0 || strncmp(base, "..", 2) == 0)) {
+        snprintf(result, result_size, "Error: Refusing to save file %llu as \"%s\"\n",
+                 (unsigned long long)entry->seq, entry->filename);
+        return -1;
+    }
+    char target[MAX_COMMAND * 2];
+    struct stat path_stat;
+    if (autosave) {
+        snprintf(target, sizeof(target), "%s/%s", path, base);
+    } else if (!path || !path[0]) {
+        snprintf(target, sizeof(target), "%s", base);
+    } else if (stat(path, &path_stat) == 0 && S_ISDIR(path_stat.st_mode)) {
+        snprintf(target, sizeof(target), "%s/%s", path, base);
+    } else {
+        snprintf(target, sizeof(target), "%s", path);
+    }
+
+    int blob_fd = shm_open(entry->blob, O_RDONLY, 0);
+    if (blob_fd < 0) {
+        snprintf(result, result_size, "Error: File %llu is no longer available\n", (unsigned long long)entry->seq);
+        return -1;
+    }
+    struct stat blob_stat;
+    if (fstat(blob_fd, &blob_stat) == -1 || (uint64_t)blob_stat.st_size != entry->stored_size) {
+        snprintf(result, result_size, "Error: File %llu has the wrong size\n", (unsigned long long)entry->seq);
+        close(blob_fd);
+        return -1;
+    }
+
+    const unsigned char *map = NULL;
+    if (entry->stored_size > 0) {
+        map = mmap(NULL, entry->stored_size, PROT_READ, MAP_SHARED, blob_fd, 0);
+        if (map == MAP_FAILED) {
+            snprintf(result, result_size, "Error: mmap failed: %s\n", strerror(errno));
+            close(blob_fd);
+            return -1;
+        }
+    }
+    close(blob_fd);
+
+    int ret = -1;
+    if (checksum(map, entry->stored_size) != entry->checksum) {
+        snprintf(result, result_size, "Error: Checksum mismatch for file %llu\n", (unsigned long long)entry->seq);
+        goto out;
+    }
+
+    int flags = (entry->compressed ? O_RDWR : O_WRONLY) | O_CREAT | O_CLOEXEC;
+    int out_fd;
+    if (autosave) {
+        size_t len = strlen(target);
+        out_fd = open(target, flags | O_EXCL, 0644);
+        for (int n = 1; out_fd < 0 && errno == EEXIST && n < 1000; n++) {
+            snprintf(target + len, sizeof(target) - len, ".%d", n);
+            out_fd = open(target, flags | O_EXCL, 0644);
+        }
+    } else {
+        out_fd = open(target, flags | O_TRUNC, 0644);
+    }
+    if (out_fd < 0) {
+        snprintf(result, result_size, "Error: %s: %s\n", target, strerror(errno));
+        goto out;
+    }
+    int failed;
+    if (entry->compressed) {
+        // Tembel açma: doğrudan hedef dosyanın eşlemesine çöz
+        failed = ftruncate(out_fd, entry->file_size) == -1;
+        unsigned char *dst = failed ? MAP_FAILED : mmap(NULL, entry->file_size, PROT_READ | PROT_WRITE, MAP_SHARED, out_fd, 0);
+        if (dst == MAP_FAILED) {
+            failed = 1;
         } else {
-            snprintf(line, sizeof(line), "[%s] File: %s (%zu bytes)\n", 
-                     model->shmp->messages[idx].sender, 
-                     model->shmp->messages[idx].filename, 
-                     model->shmp->messages[idx].data_size);
+            failed = lz_decompress(map, entry->stored_size, dst, entry->file_size) != 0;
+            munmap(dst, entry->file_size);
         }
-        strncat(buffer, line, buffer_size - offset - 1);
-        offset += strlen(line);
+    } else {
+        failed = write_all(out_fd, map, entry->file_size) == -1;
     }
-    if (offset > 0 && strcmp(buffer, last_buffer) != 0) {
-        printf("Read messages for %s: cnt=%zu, msg_index=%d, content:\n%s", 
-               model->username, model->shmp->cnt, model->shmp->msg_index, buffer);
-        strncpy(last_buffer, buffer, sizeof(last_buffer));
+    if (close(out_fd) == 0 && !failed) {
+        snprintf(result, result_size, "Saved %s (%llu bytes) to %s\n", entry->filename,
+                 (unsigned long long)entry->file_size, target);
+        ret = 0;
+    } else {
+        snprintf(result, result_size, "Error: Failed to write %s\n", target);
+    }
+
+out:
+    if (map) munmap((void *)map, entry->stored_size);
+    return ret;
+}
+
+int model_save_file(Model *model, uint64_t id, const char *path, char *result, size_t result_size) {
+    MessageEntry entry;
+    uint64_t head = atomic_load_explicit(&model->shmp->head, memory_order_acquire);
+    if (id >= head || read_slot(model, id, &entry) != 1) {
+        snprintf(result, result_size, "Error: No message with id %llu\n", (unsigned long long)id);
+        return -1;
+    }
+    if (entry.type != 1) {
+        snprintf(result, result_size, "Error: Message %llu is not a file\n", (unsigned long long)id);
+        return -1;
+    }
+    return save_entry(&entry, path, 0, result, result_size);
+}
+
+// NULL ya da "off" otomatik kaydetmeyi kapatır
+void model_set_autosave(Model *model, const char *dir) {
+    free(model->autosave_dir);
+    model->autosave_dir = (dir && strcmp(dir, "off") != 0) ? strdup(dir) : NULL;
+}
+
+// Günlük kaydını okuyucuya verilen biçime çevirir
+static void entry_from_log(const LogRecord *record, MessageEntry *entry) {
+    memset(entry, 0, sizeof(*entry));
+    entry->seq = record->seq;
+    entry->timestamp = (time_t)record->timestamp;
+    entry->type = record->type;
+    strncpy(entry->sender, record->sender, MAX_USERNAME - 1);
+    entry->filename = record->name;
+    entry->data = record->data;
+    entry->data_size = record->data_len;
+    entry->file_size = record->file_size;
+    if (record->type == 1 && record->data_len == sizeof(FileInfo)) {
+        FileInfo info;
+        memcpy(&info, record->data, sizeof(info));
+        entry->checksum = info.checksum;
+        entry->stored_size = info.stored_size;
+        entry->compressed = (info.flags & FILE_COMPRESSED) != 0;
     }
-    sem_post(&model->shmp->sem);
-}
\ No newline at end of file
+}
+
+// Tüm kelimeleri içeren mesajları en yeniden eskiye (en fazla limit tane) iletir
+// ve toplam eşleşme sayısını döndürür. Dizin okuma yolunda güncellenir; bu
+// pencere açılmadan önceki geçmiş model_init'te günlükten eklenmiştir.
+size_t model_search(Model *model, const char *query, size_t limit, MessageCallback on_message, void *data) {
+    uint64_t *ids = malloc((limit ? limit : 1) * sizeof(uint64_t));
+    if (!ids) return 0;
+    size_t total = search_query(model->search, query, ids, limit);
+    size_t shown = total < limit ? total : limit;
+
+    // Sonuçların metni günlükten, günlük yoksa halkadan alınır
+    for (size_t i = 0; i < shown; i++) {
+        MessageEntry entry;
+        LogRecord record;
+        if (model->log && msglog_get(model->log, ids[i], &record) == 0) {
+            entry_from_log(&record, &entry);
+        } else if (read_slot(model, ids[i], &entry) != 1) {
+            continue;
+        }
+        on_message(&entry, data);
+    }
+    free(ids);
+    return total;
+}
+
+int model_message_fd(Model *model) {
+    return model->notify_fd;
+}
+
+// eventfd sayacını sıfırla; ardından model_read_messages çağrılmalı
+void model_message_ack(Model *model) {
+    uint64_t count;
+    while (read(model->notify_fd, &count, sizeof(count)) < 0 && errno == EINTR) {}
+}
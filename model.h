@@ -1,52 +1,161 @@
 #ifndef MODEL_H
 #define MODEL_H
 
-#include <semaphore.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <sys/resource.h>
 #include <sys/types.h>
+#include <time.h>
+#include "history.h"
+#include "msglog.h"
+#include "search.h"
+#include "spawner.h"
+#include "stats.h"
 
 #define BUF_SIZE 4096
+#ifndef SHARED_FILE_PATH
 #define SHARED_FILE_PATH "/mymsgbuf"
+#endif
 #define MAX_COMMAND 256
 #define MAX_USERNAME 32
-#define MAX_HISTORY 50
-#define MAX_FILE_SIZE (BUF_SIZE * 2) // Allow larger files (8KB)
+#define HISTORY_SIZE 10000           // Varsayılan komut geçmişi derinliği (TERMINAL_HISTORY_SIZE ile değişir)
+#define MSG_SLOTS 2048               // Varsayılan mesaj geçmişi derinliği (TERMINAL_MSG_SLOTS ile değişir)
+#define MAX_PROCESSES 256            // Varsayılan süreç tablosu kapasitesi (TERMINAL_MAX_PROCESSES ile değişir)
+#define MSG_ARENA_PER_SLOT 128       // Yuva başına ortalama arena baytı
+#define SEARCH_BACKFILL 65536        // Açılışta günlüğün kuyruğundan dizine eklenen en fazla kayıt
+#define MAX_FILE_BLOB 64            // "/mymsgbuf.f<id>" adı için yer
+#define CACHE_LINE 64
 
+// Zaman damgaları CLOCK_MONOTONIC nanosaniye; 0 = o an henüz gelmedi
 typedef struct {
-    pid_t pid;
+    pid_t pid;           // 0 = boş yuva
+    int next_free;       // Boş yuva listesinde sıradaki (-1 = son)
     char command[MAX_COMMAND];
     int status;
+    uint64_t started;    // spawn çağrısından hemen önce
+    uint64_t spawned;    // spawn döndüğünde (exec başarılı)
+    uint64_t first_byte; // Çıktı borusundan ilk okuma
+    uint64_t eof;        // Çıktı borusunda EOF
+    uint64_t exited;     // Çocuk toplandığında
+    uint64_t rendered;   // Çıktının sonu görünüme verildiğinde
+    int has_usage;       // wait4 kaynak kullanımını verdi mi
+    struct rusage usage;
 } ProcessInfo;
 
+typedef enum {
+    PROCESS_FIRST_BYTE,
+    PROCESS_EOF,
+    PROCESS_RENDERED,
+} ProcessEvent;
+
+// Okuyucuya iletilen mesaj; filename ve data okuyucunun kendi tamponunu gösterir
 typedef struct {
+    uint64_t seq; // Halkadaki mesaj numarası
+    time_t timestamp;
     char sender[MAX_USERNAME];
     int type; // 0 = text message, 1 = file transfer
-    char filename[MAX_COMMAND]; // Name of file being sent (if type == 1)
-    char data[MAX_FILE_SIZE]; // Message or file content
+    const char *filename; // Name of file being sent (if type == 1)
+    const char *data; // Message content, NUL ile biter
     size_t data_size; // Size of data
+    uint64_t file_size; // Dosyanın tam boyutu (if type == 1)
+    uint64_t checksum;  // Gönderenin hesapladığı FNV-1a (if type == 1)
+    uint64_t stored_size; // Nesnedeki bayt sayısı (sıkıştırılmışsa file_size'dan küçük)
+    int compressed;
+    char blob[MAX_FILE_BLOB]; // Dosya içeriğini tutan salt okunur shm nesnesi
 } MessageEntry;
 
+// Sabit boyutlu dizin kaydı (88 bayt). Her yuvanın kendi sıra numarası var:
+// 0 boş, 2t+1 t numaralı mesaj yazılıyor, 2t+2 t numaralı mesaj yayında.
+// Okuyucular kopyaladıktan sonra numarayı yeniden kontrol eder (seqlock).
+typedef struct {
+    _Atomic uint64_t seq;
+    _Atomic int32_t writer; // Numara tekken yazan sürecin pid'i (0 = henüz yazılmadı)
+    uint64_t offset;   // Kaydın arenadaki mutlak (sarmayan) konumu
+    time_t timestamp;
+    uint32_t length;   // Önek dahil kayıt uzunluğu
+    int32_t type;
+    char sender[MAX_USERNAME];
+    uint64_t blob;     // Dosya mesajının shm nesnesi (0 = yok), yuva geri alınınca silinir
+    uint64_t file_size;
+} MessageSlot;
+
+// Arenadaki her kaydın önündeki uzunluk öneki; ardından dosya adı ve veri gelir
+typedef struct {
+    uint32_t name_len;
+    uint32_t data_len;
+} RecordHeader;
+
+// Dosya mesajlarının arena verisi
+#define FILE_COMPRESSED 1
+typedef struct {
+    uint64_t checksum;    // Saklanan baytların FNV-1a'sı
+    uint64_t stored_size;
+    uint32_t flags;
+    uint32_t reserved;
+} FileInfo;
+
+#define MAX_RECORD (sizeof(RecordHeader) + MAX_COMMAND + BUF_SIZE)
+
+// Kilitsiz çok yazarlı halka: küçük bir dizin ve değişken uzunluklu kayıtlar
+// için bir bayt halkası. Yazarlar dizinde numarayı head'e, arenada yeri
+// arena_tail'e fetch_add yaparak alır; ikisi ayrı önbellek satırlarında durur.
+// Segment düzeni: ShmBuf başlığı, slots[slot_count], arena[arena_size].
 typedef struct shmbuf {
-    sem_t sem;
-    size_t cnt;
-    int fd;
-    MessageEntry messages[MAX_HISTORY];
-    int msg_index;
+    _Alignas(CACHE_LINE) _Atomic uint64_t head; // Sıradaki mesaj numarası
+    _Alignas(CACHE_LINE) _Atomic uint64_t arena_tail; // Arenada ayrılan toplam bayt
+    _Alignas(CACHE_LINE) _Atomic uint32_t notify; // Her yayında artan futex kelimesi
+    _Atomic uint32_t waiters;                     // futex'te uyuyan okuyucu sayısı
+    _Alignas(CACHE_LINE) _Atomic uint32_t ready;  // Oluşturan süreç boyutları yazdı
+    uint32_t slot_count;  // İkinin kuvveti
+    uint32_t arena_size;  // İkinin kuvveti
+    _Atomic uint32_t attached; // Bağlı pencere sayısı; son ayrılan segmenti siler
+    _Alignas(CACHE_LINE) MessageSlot slots[];
 } ShmBuf;
 
 typedef struct {
-    ProcessInfo *processes;
+    ProcessInfo *processes; // Açılışta ayrılan sabit tablo; yuvalar süreç bitince geri döner
+    int process_capacity;
     int process_count;
+    int process_free;       // İlk boş yuva (-1 = tablo dolu)
     ShmBuf *shmp;
+    size_t shm_size;
+    char *arena;          // Segment içindeki bayt halkası
+    char *scratch;        // Okunan kaydın kopyalandığı yerel tampon
+    uint32_t blob_counter; // Bu sürecin oluşturduğu dosya nesneleri
+    char *autosave_dir;    // Gelen dosyaların otomatik kaydedildiği dizin (NULL = kapalı)
+    MsgLog *log;           // Kalıcı mesaj günlüğü (NULL = kapalı)
+    SearchIndex *search;   // Okunan mesajların ters dizini
+    uint64_t search_start; // [search_start, search_from): açılışta günlükten
+    uint64_t search_from;  // kesintisiz dizine eklenen numaralar
+    uint64_t read_cursor; // Bu okuyucunun bir sonraki okuyacağı mesaj numarası
+    int notify_fd;        // Yeni mesaj gelince okunabilir olan eventfd
+    pthread_t notify_thread;
+    atomic_int stopping;
     char username[MAX_USERNAME];
-    char command_history[MAX_HISTORY][MAX_COMMAND];
-    int cmd_count;
+    History *history;      // Komut geçmişi (~/.terminal_history'de kalıcı)
+    Stats *stats;          // Biten süreçlerin gecikme ve kaynak histogramları
 } Model;
 
+typedef void (*OutputCallback)(const char *chunk, size_t len, void *data);
+typedef void (*MessageCallback)(const MessageEntry *entry, void *data);
+
 Model *model_init(const char *username);
 void model_destroy(Model *model);
-void model_execute_command(Model *model, const char *command, char *output, size_t output_size);
-void model_send_message(Model *model, const char *message);
-void model_send_file(Model *model, const char *filename);
-void model_read_messages(Model *model, char *buffer, size_t buffer_size);
+int model_execute_command(Model *model, const char *command, OutputCallback on_output, void *data);
+pid_t model_spawn_command(Model *model, const char *command, const SpawnRequest *req);
+void model_process_event(Model *model, pid_t pid, ProcessEvent event);
+void model_process_exited(Model *model, pid_t pid, int status, const struct rusage *usage);
+void model_process_finished(Model *model, pid_t pid);
+int model_export_stats(Model *model, const char *path);
+void model_add_history(Model *model, const char *command);
+int model_send_message(Model *model, const char *message);
+int model_send_file(Model *model, const char *filename, int compress);
+int model_read_messages(Model *model, MessageCallback on_message, void *data);
+int model_save_file(Model *model, uint64_t id, const char *path, char *result, size_t result_size);
+void model_set_autosave(Model *model, const char *dir);
+size_t model_search(Model *model, const char *query, size_t limit, MessageCallback on_message, void *data);
+int model_message_fd(Model *model);
+void model_message_ack(Model *model);
 
 #endif
\ No newline at end of file
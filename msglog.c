@@ -0,0 +1,255 @@
+#define _GNU_SOURCE
+#include "msglog.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+// Dosya düzeni: her kayıt LogHeader, NUL ile biten ad ve veri, 8 bayta
+// hizalama dolgusu ve LogFooter'dan oluşur. Sondaki uzunluk sayesinde
+// kuyruk dosyanın sonundan geriye doğru O(kuyruk) sürede bulunur.
+// Yanındaki .idx dosyası her LOG_INDEX_STRIDE baytta bir (seq, zaman,
+// konum) kaydı tutar; sıra numarasıyla ya da zamanla arama buradan başlar.
+#define LOG_MAGIC 0x4c47534du // "MSGL"
+#define LOG_INDEX_STRIDE (64 * 1024)
+#define LOG_MAX_RECORD (64u << 20)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t length;     // Başlık, gövde ve son ek dahil, 8'in katı
+    uint64_t seq;
+    int64_t timestamp;
+    uint64_t file_size;
+    int32_t type;
+    uint32_t name_len;
+    uint32_t data_len;
+    uint32_t reserved;
+    char sender[LOG_SENDER_SIZE];
+} LogHeader;
+
+typedef struct {
+    uint32_t length;
+    uint32_t magic;
+} LogFooter;
+
+typedef struct {
+    uint64_t seq;
+    int64_t timestamp;
+    uint64_t offset;
+} IndexEntry;
+
+struct MsgLog {
+    int fd;
+    int index_fd;
+    const char *map;
+    size_t map_size;
+    const char *index_map;
+    size_t index_map_size;
+    const IndexEntry *index;
+    size_t index_count;
+};
+
+static void remap(int fd, const char **map, size_t *map_size) {
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size == *map_size) return;
+    if (*map) munmap((void *)*map, *map_size);
+    *map = NULL;
+    *map_size = 0;
+    if (st.st_size == 0) return;
+    void *p = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) return;
+    *map = p;
+    *map_size = st.st_size;
+}
+
+// Diğer süreçlerin eklediği kayıtları görmek için eşlemeleri büyüt
+static void log_refresh(MsgLog *log) {
+    remap(log->fd, &log->map, &log->map_size);
+    remap(log->index_fd, &log->index_map, &log->index_map_size);
+    log->index = (const IndexEntry *)log->index_map;
+    log->index_count = log->index_map_size / sizeof(IndexEntry);
+}
+
+// offset'teki kaydı doğrular; geçerliyse uzunluğunu döndürür, değilse 0
+static size_t record_at(const MsgLog *log, size_t offset, LogRecord *record) {
+    if (offset + sizeof(LogHeader) + sizeof(LogFooter) > log->map_size) return 0;
+    const LogHeader *header = (const LogHeader *)(log->map + offset);
+    if (header->magic != LOG_MAGIC || header->length > log->map_size - offset ||
+        header->length < sizeof(LogHeader) + sizeof(LogFooter) ||
+        (size_t)header->name_len + header->data_len + 2 > header->length - sizeof(LogHeader) - sizeof(LogFooter)) {
+        return 0;
+    }
+    const LogFooter *footer = (const LogFooter *)(log->map + offset + header->length - sizeof(LogFooter));
+    if (footer->magic != LOG_MAGIC || footer->length != header->length) return 0;
+
+    if (record) {
+        const char *body = (const char *)(header + 1);
+        record->seq = header->seq;
+        record->timestamp = header->timestamp;
+        record->type = header->type;
+        record->sender = header->sender;
+        record->name = body;
+        record->name_len = header->name_len;
+        record->data = body + header->name_len + 1;
+        record->data_len = header->data_len;
+        record->file_size = header->file_size;
+    }
+    return header->length;
+}
+
+// Sondaki yarım kalmış yazımları atlayarak geçerli verinin bittiği konum
+static size_t valid_end(const MsgLog *log) {
+    size_t end = log->map_size;
+    if (end >= sizeof(LogFooter)) {
+        const LogFooter *footer = (const LogFooter *)(log->map + end - sizeof(LogFooter));
+        if (footer->magic == LOG_MAGIC && footer->length <= end && record_at(log, end - footer->length, NULL)) {
+            return end;
+        }
+    }
+    // Son ek bozuk: son dizin noktasından ileri doğru tara
+    size_t offset = log->index_count ? log->index[log->index_count - 1].offset : 0;
+    if (offset >= log->map_size) offset = 0;
+    size_t length;
+    while ((length = record_at(log, offset, NULL)) > 0) offset += length;
+    return offset;
+}
+
+MsgLog *msglog_open(const char *path) {
+    char index_path[4096];
+    snprintf(index_path, sizeof(index_path), "%s.idx", path);
+
+    MsgLog *log = calloc(1, sizeof(MsgLog));
+    if (!log) return NULL;
+    log->fd = open(path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    log->index_fd = open(index_path, O_RDWR | O_APPEND | O_CREAT | O_CLOEXEC, 0600);
+    if (log->fd < 0 || log->index_fd < 0) {
+        perror("Failed to open message log");
+        if (log->fd >= 0) close(log->fd);
+        if (log->index_fd >= 0) close(log->index_fd);
+        free(log);
+        return NULL;
+    }
+    log_refresh(log);
+    return log;
+}
+
+void msglog_close(MsgLog *log) {
+    if (!log) return;
+    if (log->map) munmap((void *)log->map, log->map_size);
+    if (log->index_map) munmap((void *)log->index_map, log->index_map_size);
+    close(log->fd);
+    close(log->index_fd);
+    free(log);
+}
+
+// Tek bir writev ile ekler; O_APPEND sayesinde süreçler arası kayıtlar karışmaz
+int msglog_append(MsgLog *log, const LogRecord *record) {
+    static const char zeros[16];
+    size_t body = (size_t)record->name_len + 1 + record->data_len + 1;
+    size_t padding = (8 - (sizeof(LogHeader) + body) % 8) % 8;
+    size_t length = sizeof(LogHeader) + body + padding + sizeof(LogFooter);
+    if (length > LOG_MAX_RECORD) return -1;
+
+    LogHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = LOG_MAGIC;
+    header.length = (uint32_t)length;
+    header.seq = record->seq;
+    header.timestamp = record->timestamp;
+    header.file_size = record->file_size;
+    header.type = record->type;
+    header.name_len = record->name_len;
+    header.data_len = record->data_len;
+    strncpy(header.sender, record->sender, LOG_SENDER_SIZE - 1);
+    LogFooter footer = { (uint32_t)length, LOG_MAGIC };
+
+    struct iovec iov[6] = {
+        { &header, sizeof(header) },
+        { (void *)(record->name ? record->name : ""), record->name_len },
+        { (void *)zeros, 1 },
+        { (void *)(record->data ? record->data : ""), record->data_len },
+        { (void *)zeros, 1 + padding },
+        { &footer, sizeof(footer) },
+    };
+    if (writev(log->fd, iov, 6) != (ssize_t)length) return -1;
+
+    // Yazım bir dizin sınırını geçtiyse (ya da dosyanın ilk kaydıysa) dizine ekle
+    off_t end = lseek(log->fd, 0, SEEK_CUR);
+    if (end < 0) return 0;
+    uint64_t start = (uint64_t)end - length;
+    if (start == 0 || start / LOG_INDEX_STRIDE != ((uint64_t)end - 1) / LOG_INDEX_STRIDE) {
+        IndexEntry entry = { record->seq, record->timestamp, start };
+        if (write(log->index_fd, &entry, sizeof(entry)) != sizeof(entry)) perror("Failed to write log index");
+    }
+    return 0;
+}
+
+// Son count kaydı eskiden yeniye iletir; dosyanın yalnızca kuyruğuna dokunur
+size_t msglog_tail(MsgLog *log, size_t count, LogCallback callback, void *data) {
+    log_refresh(log);
+    size_t end = valid_end(log);
+    size_t start = end;
+    size_t found = 0;
+    while (found < count && start >= sizeof(LogFooter)) {
+        const LogFooter *footer = (const LogFooter *)(log->map + start - sizeof(LogFooter));
+        if (footer->magic != LOG_MAGIC || footer->length > start || !record_at(log, start - footer->length, NULL)) break;
+        start -= footer->length;
+        found++;
+    }
+
+    size_t delivered = 0;
+    LogRecord record;
+    size_t length;
+    while (start < end && (length = record_at(log, start, &record)) > 0) {
+        delivered++;
+        if (callback(&record, data)) break;
+        start += length;
+    }
+    return delivered;
+}
+
+// Dizinde key'i geçmeyen son noktayı ikili aramayla bulur. Eşzamanlı
+// yazarlar sırayı biraz bozabildiği için bir önceki noktadan başlanır.
+static size_t index_search(const MsgLog *log, uint64_t key, int by_time) {
+    size_t lo = 0, hi = log->index_count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint64_t value = by_time ? (uint64_t)log->index[mid].timestamp : log->index[mid].seq;
+        if (value <= key) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo >= 2) return log->index[lo - 2].offset;
+    return 0;
+}
+
+size_t msglog_since(MsgLog *log, int64_t timestamp, LogCallback callback, void *data) {
+    log_refresh(log);
+    size_t offset = index_search(log, (uint64_t)timestamp, 1);
+    size_t delivered = 0;
+    LogRecord record;
+    size_t length;
+    while ((length = record_at(log, offset, &record)) > 0) {
+        offset += length;
+        if (record.timestamp < timestamp) continue;
+        delivered++;
+        if (callback(&record, data)) break;
+    }
+    return delivered;
+}
+
+int msglog_get(MsgLog *log, uint64_t seq, LogRecord *record) {
+    log_refresh(log);
+    size_t offset = index_search(log, seq, 0);
+    // Sıra numarasıyla en fazla birkaç dizin aralığı ileri taranır
+    size_t limit = offset + 3 * LOG_INDEX_STRIDE;
+    size_t length;
+    while (offset < limit && (length = record_at(log, offset, record)) > 0) {
+        if (record->seq == seq) return 0;
+        offset += length;
+    }
+    return -1;
+}
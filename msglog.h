@@ -0,0 +1,35 @@
+#ifndef MSGLOG_H
+#define MSGLOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define LOG_SENDER_SIZE 32
+
+// Günlükteki bir kayıt; okurken işaretçiler dosya eşlemesini gösterir ve
+// NUL ile biter, bir sonraki msglog çağrısına kadar geçerlidir
+typedef struct {
+    uint64_t seq;
+    int64_t timestamp;
+    int32_t type;
+    const char *sender;
+    const char *name;
+    uint32_t name_len;
+    const char *data;
+    uint32_t data_len;
+    uint64_t file_size;
+} LogRecord;
+
+// Sıfır dışı dönerse tarama durur
+typedef int (*LogCallback)(const LogRecord *record, void *data);
+
+typedef struct MsgLog MsgLog;
+
+MsgLog *msglog_open(const char *path);
+void msglog_close(MsgLog *log);
+int msglog_append(MsgLog *log, const LogRecord *record);
+size_t msglog_tail(MsgLog *log, size_t count, LogCallback callback, void *data);
+size_t msglog_since(MsgLog *log, int64_t timestamp, LogCallback callback, void *data);
+int msglog_get(MsgLog *log, uint64_t seq, LogRecord *record);
+
+#endif
@@ -0,0 +1,442 @@
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parser.h"
+
+#define ARENA_BLOCK_SIZE 4096
+
+// Tek yönlü bellek bölgesi: komut başına bir kez sıfırlanır, token başına malloc yok
+typedef struct ArenaBlock {
+    struct ArenaBlock *next;
+    size_t size;
+    size_t used;
+    char data[];
+} ArenaBlock;
+
+struct Parser {
+    ArenaBlock *blocks;     // En yeni blok başta
+    size_t total;           // Tüm blokların toplam kapasitesi
+    const char *input;
+    const char *end;        // Girdinin sonu (kelime kopyası için üst sınır)
+    const char *p;          // Okuma konumu
+    char error[128];
+};
+
+// Kelime listesi: argv boyutu aşama bitene kadar bilinmiyor
+typedef struct Word {
+    char *text;
+    struct Word *next;
+} Word;
+
+static ArenaBlock *arena_block_new(size_t size) {
+    ArenaBlock *block = malloc(sizeof(ArenaBlock) + size);
+    if (!block) return NULL;
+    block->next = NULL;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
+
+static void *arena_alloc(Parser *parser, size_t size) {
+    size = (size + 7) & ~(size_t)7;
+    ArenaBlock *block = parser->blocks;
+    if (!block || block->used + size > block->size) {
+        size_t block_size = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        block = arena_block_new(block_size);
+        if (!block) return NULL;
+        block->next = parser->blocks;
+        parser->blocks = block;
+        parser->total += block_size;
+    }
+    void *ptr = block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+// Son ayrılan alanı küçült (kelime kopyalanırken üst sınır kadar yer ayrılır)
+static void arena_shrink_last(Parser *parser, void *ptr, size_t size) {
+    ArenaBlock *block = parser->blocks;
+    block->used = (size_t)((char *)ptr - block->data) + ((size + 7) & ~(size_t)7);
+}
+
+static char *arena_strndup(Parser *parser, const char *s, size_t len) {
+    char *copy = arena_alloc(parser, len + 1);
+    if (!copy) return NULL;
+    memcpy(copy, s, len);
+    copy[len] = '\0';
+    return copy;
+}
+
+Parser *parser_new(void) {
+    Parser *parser = calloc(1, sizeof(Parser));
+    if (!parser) return NULL;
+    parser->blocks = arena_block_new(ARENA_BLOCK_SIZE);
+    parser->total = ARENA_BLOCK_SIZE;
+    return parser;
+}
+
+// Birden fazla blok biriktiyse tek büyük blokta birleştir; kararlı durumda malloc yok
+void parser_reset(Parser *parser) {
+    if (parser->blocks && parser->blocks->next) {
+        ArenaBlock *block = parser->blocks;
+        while (block) {
+            ArenaBlock *next = block->next;
+            free(block);
+            block = next;
+        }
+        parser->blocks = arena_block_new(parser->total);
+    }
+    if (parser->blocks) parser->blocks->used = 0;
+    parser->error[0] = '\0';
+}
+
+void parser_free(Parser *parser) {
+    if (!parser) return;
+    ArenaBlock *block = parser->blocks;
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    free(parser);
+}
+
+const char *parser_error(const Parser *parser) {
+    return parser->error;
+}
+
+// Karakter sınıfları: tek tablo bakışıyla kelime sonu ve özel karakterler
+#define CHAR_META    1 // Kelimeyi bitirir
+#define CHAR_SPECIAL 2 // Tırnak, kaçış ya da genişletme: yavaş yola düş
+
+static const unsigned char char_class[256] = {
+    ['\0'] = CHAR_META, [' '] = CHAR_META, ['\t'] = CHAR_META, ['\n'] = CHAR_META,
+    ['|'] = CHAR_META, ['&'] = CHAR_META, [';'] = CHAR_META, ['<'] = CHAR_META,
+    ['>'] = CHAR_META, ['('] = CHAR_META, [')'] = CHAR_META,
+    ['\\'] = CHAR_SPECIAL, ['\''] = CHAR_SPECIAL, ['"'] = CHAR_SPECIAL, ['$'] = CHAR_SPECIAL,
+    ['`'] = CHAR_SPECIAL, ['*'] = CHAR_SPECIAL, ['?'] = CHAR_SPECIAL, ['['] = CHAR_SPECIAL,
+    ['~'] = CHAR_SPECIAL, ['='] = CHAR_SPECIAL,
+};
+
+static int is_blank(char c) {
+    return c == ' ' || c == '\t';
+}
+
+// Kelimeyi bitiren karakterler
+static int is_meta(char c) {
+    return char_class[(unsigned char)c] == CHAR_META;
+}
+
+static int is_name_char(char c, int first) {
+    return c == '_' || isalpha((unsigned char)c) || (!first && isdigit((unsigned char)c));
+}
+
+static int is_reserved_word(const char *word) {
+    static const char *const reserved[] = {
+        "if", "then", "else", "elif", "fi", "case", "esac", "for", "while",
+        "until", "do", "done", "function", "select", "!", "{", "}", "[[", NULL
+    };
+    for (int i = 0; reserved[i]; i++) {
+        if (strcmp(word, reserved[i]) == 0) return 1;
+    }
+    return 0;
+}
+
+// Tırnakları ve kaçışları çözerek tek kelimeyi arenaya kopyalar.
+// Genişletme gerektiren bir şey görürse *needs_shell'i 1 yapar.
+static char *parse_word(Parser *parser, int first_word, int *needs_shell) {
+    const char *p = parser->p;
+    size_t limit = (size_t)(parser->end - p) + 1;
+    char *out = arena_alloc(parser, limit);
+    if (!out) {
+        snprintf(parser->error, sizeof(parser->error), "Out of memory");
+        return NULL;
+    }
+    size_t len = 0;
+    int quoted = 0;
+    int name_prefix = first_word; // VAR=deger ataması mı?
+
+    while (!is_meta(*p)) {
+        // Hızlı yol: sıradan karakter dizisini tek seferde kopyala
+        if (!char_class[(unsigned char)*p] && !name_prefix) {
+            const char *run = p;
+            while (!char_class[(unsigned char)*p]) p++;
+            memcpy(out + len, run, (size_t)(p - run));
+            len += (size_t)(p - run);
+            continue;
+        }
+        char c = *p;
+        if (c == '\\') {
+            if (p[1] == '\0') {
+                out[len++] = '\\';
+                p++;
+            } else {
+                out[len++] = p[1];
+                p += 2;
+            }
+            quoted = 1;
+            name_prefix = 0;
+        } else if (c == '\'') {
+            const char *end = strchr(p + 1, '\'');
+            if (!end) {
+                snprintf(parser->error, sizeof(parser->error), "Unclosed quotes");
+                return NULL;
+            }
+            memcpy(out + len, p + 1, (size_t)(end - p - 1));
+            len += (size_t)(end - p - 1);
+            p = end + 1;
+            quoted = 1;
+            name_prefix = 0;
+        } else if (c == '"') {
+            p++;
+            while (*p && *p != '"') {
+                if (*p == '\\' && (p[1] == '$' || p[1] == '`' || p[1] == '"' || p[1] == '\\')) {
+                    out[len++] = p[1];
+                    p += 2;
+                    continue;
+                }
+                if (*p == '$' || *p == '`') *needs_shell = 1;
+                out[len++] = *p++;
+            }
+            if (*p != '"') {
+                snprintf(parser->error, sizeof(parser->error), "Unclosed quotes");
+                return NULL;
+            }
+            p++;
+            quoted = 1;
+            name_prefix = 0;
+        } else {
+            if (c == '$' || c == '`' || c == '*' || c == '?' || c == '[') *needs_shell = 1;
+            if (c == '~' && len == 0 && !quoted) *needs_shell = 1;
+            if (c == '=' && name_prefix && len > 0) *needs_shell = 1;
+            if (name_prefix && !is_name_char(c, len == 0)) name_prefix = 0;
+            out[len++] = c;
+            p++;
+        }
+    }
+
+    out[len] = '\0';
+    arena_shrink_last(parser, out, len + 1);
+    parser->p = p;
+    return out;
+}
+
+// Tüm satırı tek bir sh -c aşamasına çevir (alt kabuk, heredoc, ayrılmış kelimeler...)
+static CommandLine *shell_fallback(Parser *parser, CommandLine *line) {
+    Pipeline *pipeline = arena_alloc(parser, sizeof(Pipeline));
+    Stage *stage = arena_alloc(parser, sizeof(Stage));
+    char **argv = arena_alloc(parser, sizeof(char *));
+    char *text = arena_strndup(parser, parser->input, (size_t)(parser->end - parser->input));
+    if (!pipeline || !stage || !argv || !text) {
+        snprintf(parser->error, sizeof(parser->error), "Out of memory");
+        return NULL;
+    }
+    argv[0] = NULL;
+    memset(stage, 0, sizeof(Stage));
+    stage->argv = argv;
+    stage->needs_shell = 1;
+    stage->text = text;
+    memset(pipeline, 0, sizeof(Pipeline));
+    pipeline->stages = stage;
+    pipeline->stage_count = 1;
+    pipeline->condition = RUN_ALWAYS;
+    pipeline->text = text;
+    line->pipelines = pipeline;
+    line->pipeline_count = 1;
+    line->needs_shell = 1;
+    return line;
+}
+
+// Toplanan kelimelerden argv dizisini kur
+static int finish_stage(Parser *parser, Stage *stage, Word *words, const char *start, const char *end) {
+    char **argv = arena_alloc(parser, sizeof(char *) * (size_t)(stage->argc + 1));
+    if (!argv) return -1;
+    int i = 0;
+    for (Word *w = words; w; w = w->next) argv[i++] = w->text;
+    argv[i] = NULL;
+    stage->argv = argv;
+    while (end > start && is_blank(end[-1])) end--;
+    stage->text = arena_strndup(parser, start, (size_t)(end - start));
+    return stage->text ? 0 : -1;
+}
+
+CommandLine *parser_parse(Parser *parser, const char *input) {
+    parser->input = input;
+    parser->end = input + strlen(input);
+    parser->p = input;
+    parser->error[0] = '\0';
+
+    CommandLine *line = arena_alloc(parser, sizeof(CommandLine));
+    if (!line) return NULL;
+    memset(line, 0, sizeof(CommandLine));
+
+    Pipeline *pipeline = NULL, *last_pipeline = NULL;
+    Stage *stage = NULL, *last_stage = NULL;
+    Word *words = NULL, *last_word = NULL;
+    Redirect *last_redirect = NULL;
+    RunCondition condition = RUN_ALWAYS;
+    const char *stage_start = NULL, *pipeline_start = NULL;
+    int pending_operator = 0; // |, && ya da || sonrası komut bekleniyor
+
+    for (;;) {
+        while (is_blank(*parser->p)) parser->p++;
+        const char *p = parser->p;
+        char c = *p;
+
+        // Kelime başındaki # yorum başlatır: satırın geri kalanı yok sayılır
+        int at_end = (c == '\0' || c == '#');
+        int is_operator = (c == '|' || c == '&' || c == ';' || c == '\n');
+
+        if (c == '(' || c == ')' || (c == '<' && p[1] == '<') || (c == '<' && p[1] == '>') ||
+            (c == '&' && p[1] == '>') || (c == '<' && p[1] == '(') || (c == '>' && p[1] == '(')) {
+            return shell_fallback(parser, line);
+        }
+
+        if (at_end || is_operator) {
+            // Mevcut aşamayı kapat
+            if (stage) {
+                if (finish_stage(parser, stage, words, stage_start, p) < 0) goto oom;
+                if (stage->argc > 0 && is_reserved_word(stage->argv[0])) return shell_fallback(parser, line);
+                words = last_word = NULL;
+                last_redirect = NULL;
+            } else if (c == '|' || (c == '&' && p[1] == '&')) {
+                snprintf(parser->error, sizeof(parser->error), "syntax error near unexpected token '%.*s'",
+                         p[1] == c ? 2 : 1, p);
+                return NULL;
+            } else if (pending_operator && (at_end || c == ';' || c == '&')) {
+                snprintf(parser->error, sizeof(parser->error), "syntax error near unexpected token '%s'",
+                         at_end ? "newline" : (c == ';' ? ";" : "&"));
+                return NULL;
+            } else if ((c == ';' || c == '&') && !pipeline) {
+                snprintf(parser->error, sizeof(parser->error), "syntax error near unexpected token '%c'", c);
+                return NULL;
+            }
+
+            if (c == '|' && p[1] != '|') {
+                // Aşama ayracı: aynı boru hattında devam et
+                stage = NULL;
+                parser->p = p + 1;
+                pending_operator = 1;
+                continue;
+            }
+
+            // Boru hattını kapat
+            if (pipeline) {
+                const char *end = p;
+                while (end > pipeline_start && is_blank(end[-1])) end--;
+                pipeline->text = arena_strndup(parser, pipeline_start, (size_t)(end - pipeline_start));
+                if (!pipeline->text) goto oom;
+                if (c == '&' && p[1] != '&') pipeline->background = 1;
+            }
+            pipeline = NULL;
+            stage = NULL;
+
+            if (at_end) break;
+            if (c == '&' && p[1] == '&') {
+                condition = RUN_IF_SUCCESS;
+                parser->p = p + 2;
+                pending_operator = 1;
+            } else if (c == '|') {
+                condition = RUN_IF_FAILURE;
+                parser->p = p + 2;
+                pending_operator = 1;
+            } else {
+                condition = RUN_ALWAYS;
+                parser->p = p + 1;
+                pending_operator = 0;
+            }
+            continue;
+        }
+
+        // Yeni bir boru hattı / aşama başlat
+        if (!pipeline) {
+            pipeline = arena_alloc(parser, sizeof(Pipeline));
+            if (!pipeline) goto oom;
+            memset(pipeline, 0, sizeof(Pipeline));
+            pipeline->condition = condition;
+            pipeline_start = p;
+            if (last_pipeline) last_pipeline->next = pipeline;
+            else line->pipelines = pipeline;
+            last_pipeline = pipeline;
+            last_stage = NULL;
+            line->pipeline_count++;
+        }
+        if (!stage) {
+            stage = arena_alloc(parser, sizeof(Stage));
+            if (!stage) goto oom;
+            memset(stage, 0, sizeof(Stage));
+            stage_start = p;
+            if (last_stage) last_stage->next = stage;
+            else pipeline->stages = stage;
+            last_stage = stage;
+            pipeline->stage_count++;
+        }
+        pending_operator = 0;
+
+        // Yönlendirme: [N]<, [N]>, [N]>>, [N]>|, [N]>&M, [N]<&M
+        const char *q = p;
+        while (isdigit((unsigned char)*q)) q++;
+        if (*q == '<' || *q == '>') {
+            Redirect *redirect = arena_alloc(parser, sizeof(Redirect));
+            if (!redirect) goto oom;
+            memset(redirect, 0, sizeof(Redirect));
+            redirect->fd = (q > p) ? atoi(p) : (*q == '<' ? 0 : 1);
+            if (*q == '<') {
+                redirect->type = REDIRECT_IN;
+                q++;
+            } else if (q[1] == '>') {
+                redirect->type = REDIRECT_APPEND;
+                q += 2;
+            } else {
+                redirect->type = REDIRECT_OUT;
+                q += (q[1] == '|') ? 2 : 1;
+            }
+            if (*q == '&' && redirect->type != REDIRECT_APPEND) {
+                q++;
+                if (!isdigit((unsigned char)*q)) return shell_fallback(parser, line); // >&- gibi
+                redirect->type = REDIRECT_DUP;
+                redirect->dup_fd = atoi(q);
+                while (isdigit((unsigned char)*q)) q++;
+                if (!is_meta(*q)) return shell_fallback(parser, line);
+                parser->p = q;
+            } else {
+                parser->p = q;
+                while (is_blank(*parser->p)) parser->p++;
+                if (*parser->p == '\0') {
+                    snprintf(parser->error, sizeof(parser->error), "syntax error near unexpected token 'newline'");
+                    return NULL;
+                }
+                if (is_meta(*parser->p)) {
+                    snprintf(parser->error, sizeof(parser->error), "syntax error near unexpected token '%c'", *parser->p);
+                    return NULL;
+                }
+                redirect->target = parse_word(parser, 0, &stage->needs_shell);
+                if (!redirect->target) return NULL;
+            }
+            if (last_redirect) last_redirect->next = redirect;
+            else stage->redirects = redirect;
+            last_redirect = redirect;
+            continue;
+        }
+
+        // Sıradan kelime
+        Word *word = NULL;
+        char *text = parse_word(parser, stage->argc == 0, &stage->needs_shell);
+        if (!text) return NULL;
+        word = arena_alloc(parser, sizeof(Word));
+        if (!word) goto oom;
+        word->text = text;
+        word->next = NULL;
+        if (last_word) last_word->next = word;
+        else words = word;
+        last_word = word;
+        stage->argc++;
+    }
+
+    return line;
+
+oom:
+    snprintf(parser->error, sizeof(parser->error), "Out of memory");
+    return NULL;
+}
@@ -0,0 +1,59 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stddef.h>
+
+typedef enum {
+    REDIRECT_IN,     // <
+    REDIRECT_OUT,    // > ve >|
+    REDIRECT_APPEND, // >>
+    REDIRECT_DUP     // N>&M, N<&M
+} RedirectType;
+
+typedef struct Redirect {
+    int fd;              // Yönlendirilen tanımlayıcı (varsayılan 0 ya da 1)
+    RedirectType type;
+    const char *target;  // Dosya adı (REDIRECT_DUP için NULL)
+    int dup_fd;          // N>&M için M
+    struct Redirect *next;
+} Redirect;
+
+typedef struct Stage {
+    char **argv;         // NULL ile biten argüman listesi
+    int argc;
+    Redirect *redirects; // Yazıldığı sırayla uygulanır
+    int needs_shell;     // $, `, glob, ~ ya da atama var: sh -c text ile çalıştır
+    const char *text;    // Aşamanın ham metni
+    struct Stage *next;
+} Stage;
+
+typedef enum {
+    RUN_ALWAYS,      // ; ya da satır başı
+    RUN_IF_SUCCESS,  // &&
+    RUN_IF_FAILURE   // ||
+} RunCondition;
+
+typedef struct Pipeline {
+    Stage *stages;
+    int stage_count;
+    RunCondition condition; // Önceki boru hattının sonucuna göre çalışma koşulu
+    int background;         // & ile bitti
+    const char *text;       // Boru hattının ham metni
+    struct Pipeline *next;
+} Pipeline;
+
+typedef struct {
+    Pipeline *pipelines;
+    int pipeline_count;
+    int needs_shell;        // Desteklenmeyen sözdizimi: satır tek bir sh -c aşaması oldu
+} CommandLine;
+
+typedef struct Parser Parser;
+
+Parser *parser_new(void);
+void parser_reset(Parser *parser);
+void parser_free(Parser *parser);
+CommandLine *parser_parse(Parser *parser, const char *input);
+const char *parser_error(const Parser *parser);
+
+#endif
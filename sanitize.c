@@ -0,0 +1,590 @@
+#define _GNU_SOURCE
+#include "sanitize.h"
+#include <stdlib.h>
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SANITIZE_X86 1
+#endif
+
+// Akış iki katmanda işlenir: önce "temiz önek" (geçerli UTF-8, denetim karakteri
+// ve ESC yok) tek seferde bulunup kopyalanır; yalnızca özel baytlar tek tek ele
+// alınır. Önek taraması AVX2'de tam UTF-8 doğrulaması (Keiser-Lemire tabloları),
+// SSE2'de ASCII hızlı yolu, diğer yerlerde skaler döngüdür.
+#define SGR_MAX_PARAMS 16
+#define OUT_INITIAL 8192
+#define SHORT_RUN 64 // Bu kadar temiz bayttan kısa koşular vektörsüz taranır
+#define SCRUB_MAX 4096 // Kirli bölgede bir seferde işlenen en çok bayt
+
+static const char replacement[] = "\xef\xbf\xbd"; // U+FFFD
+
+enum { STATE_TEXT, STATE_ESC, STATE_CSI, STATE_OSC, STATE_OSC_ESC };
+
+struct Sanitizer {
+    TextStyle style;
+    int state;
+    int params[SGR_MAX_PARAMS];
+    int param_count;
+    int private_csi;          // '?' ön ekli ya da ara baytlı CSI: SGR değil
+    unsigned char carry[4];   // Parçanın sonunda yarım kalan UTF-8 dizisi
+    size_t carry_len;
+    char *out;                // Aynı stildeki temizlenmiş metin
+    size_t out_len;
+    size_t out_cap;
+};
+
+Sanitizer *sanitizer_new(void) {
+    Sanitizer *sanitizer = calloc(1, sizeof(Sanitizer));
+    if (!sanitizer) return NULL;
+    sanitizer->style.fg = STYLE_DEFAULT;
+    sanitizer->style.bg = STYLE_DEFAULT;
+    sanitizer->out_cap = OUT_INITIAL;
+    sanitizer->out = malloc(sanitizer->out_cap);
+    if (!sanitizer->out) {
+        free(sanitizer);
+        return NULL;
+    }
+    return sanitizer;
+}
+
+// Yeni komutun çıktısı öncekinin yarım kaçışını, rengini ve UTF-8 artığını devralmasın
+void sanitizer_reset(Sanitizer *sanitizer) {
+    if (!sanitizer) return;
+    sanitizer->style.fg = STYLE_DEFAULT;
+    sanitizer->style.bg = STYLE_DEFAULT;
+    sanitizer->style.flags = 0;
+    sanitizer->state = STATE_TEXT;
+    sanitizer->param_count = 0;
+    sanitizer->private_csi = 0;
+    sanitizer->carry_len = 0;
+    sanitizer->out_len = 0;
+}
+
+void sanitizer_free(Sanitizer *sanitizer) {
+    if (!sanitizer) return;
+    free(sanitizer->out);
+    free(sanitizer);
+}
+
+int style_is_default(const TextStyle *style) {
+    return style->fg == STYLE_DEFAULT && style->bg == STYLE_DEFAULT && style->flags == 0;
+}
+
+static int reserve(Sanitizer *s, size_t len) {
+    size_t cap = s->out_cap;
+    while (cap < s->out_len + len) cap *= 2;
+    char *out = realloc(s->out, cap);
+    if (!out) return -1;
+    s->out = out;
+    s->out_cap = cap;
+    return 0;
+}
+
+static inline void emit(Sanitizer *s, const void *text, size_t len) {
+    if (__builtin_expect(s->out_len + len > s->out_cap, 0) && reserve(s, len) == -1) return;
+    memcpy(s->out + s->out_len, text, len);
+    s->out_len += len;
+}
+
+// İkili veride sık çağrılır; sabit uzunluklu kopya satır içine açılır
+static inline void emit_replacement(Sanitizer *s) {
+    if (__builtin_expect(s->out_len + 3 > s->out_cap, 0) && reserve(s, 3) == -1) return;
+    memcpy(s->out + s->out_len, replacement, 3);
+    s->out_len += 3;
+}
+
+static void flush(Sanitizer *s, SanitizeCallback callback, void *user_data) {
+    if (s->out_len == 0) return;
+    callback(s->out, s->out_len, &s->style, user_data);
+    s->out_len = 0;
+}
+
+// s'deki UTF-8 dizisini çözer: geçerliyse uzunluğu, dizi avail'de bitmiyorsa
+// (ama buraya kadar geçerliyse) 0, geçersizse -k döner; k değiştirilecek
+// en uzun geçerli alt parçanın uzunluğudur (en az 1)
+static inline int decode(const unsigned char *s, size_t avail) {
+    unsigned char c = s[0];
+    if (c < 0x80) return 1;
+    int need;
+    unsigned char lo = 0x80, hi = 0xbf; // İkinci bayt aralığı
+    if (c < 0xc2) return -1;
+    else if (c < 0xe0) need = 2;
+    else if (c < 0xf0) {
+        need = 3;
+        if (c == 0xe0) lo = 0xa0;       // Fazla uzun
+        else if (c == 0xed) hi = 0x9f;  // Vekil çiftler
+    } else if (c < 0xf5) {
+        need = 4;
+        if (c == 0xf0) lo = 0x90;
+        else if (c == 0xf4) hi = 0x8f;  // U+10FFFF üstü
+    } else {
+        return -1;
+    }
+    for (int i = 1; i < need; i++) {
+        if ((size_t)i >= avail) return 0;
+        unsigned char b = s[i];
+        if (i == 1 ? (b < lo || b > hi) : (b & 0xc0) != 0x80) return -i;
+    }
+    return need;
+}
+
+static inline int is_plain(unsigned char c) {
+    return (c >= 0x20 && c < 0x7f) || c == '\n' || c == '\t';
+}
+
+static size_t clean_prefix_scalar(const unsigned char *s, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        unsigned char c = s[i];
+        if (is_plain(c)) {
+            i++;
+            continue;
+        }
+        if (c < 0x80) break;
+        int n = decode(s + i, len - i);
+        if (n <= 0) break;
+        i += (size_t)n;
+    }
+    return i;
+}
+
+#ifdef SANITIZE_X86
+// 16 baytlık bloklarda ASCII hızlı yolu; ilk ASCII dışı baytta skaler çözücüye düşer
+__attribute__((target("sse2")))
+static size_t clean_prefix_sse2(const unsigned char *s, size_t len) {
+    const __m128i space = _mm_set1_epi8(0x20);
+    const __m128i del = _mm_set1_epi8(0x7f);
+    const __m128i newline = _mm_set1_epi8('\n');
+    const __m128i tab = _mm_set1_epi8('\t');
+    size_t i = 0;
+    while (i < len) {
+        if (i + 16 > len) return i + clean_prefix_scalar(s + i, len - i);
+        __m128i x = _mm_loadu_si128((const __m128i *)(s + i));
+        // İşaretli karşılaştırma: < 0x20 hem denetim karakterlerini hem >= 0x80 baytları yakalar
+        __m128i special = _mm_cmplt_epi8(x, space);
+        special = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi8(x, newline), _mm_cmpeq_epi8(x, tab)), special);
+        special = _mm_or_si128(special, _mm_cmpeq_epi8(x, del));
+        int mask = _mm_movemask_epi8(special);
+        if (!mask) {
+            i += 16;
+            continue;
+        }
+        i += (size_t)__builtin_ctz((unsigned)mask);
+        if (s[i] < 0x80) return i;
+        int n = decode(s + i, len - i);
+        if (n <= 0) return i;
+        i += (size_t)n;
+    }
+    return i;
+}
+
+// Keiser-Lemire sınıflandırma tabloları: bir bayt ve önceki üç bayttan hata bitleri
+#define TOO_SHORT (1 << 0)
+#define TOO_LONG (1 << 1)
+#define OVERLONG_3 (1 << 2)
+#define TOO_LARGE (1 << 3)
+#define SURROGATE (1 << 4)
+#define OVERLONG_2 (1 << 5)
+#define TOO_LARGE_1000 (1 << 6)
+#define OVERLONG_4 (1 << 6)
+#define TWO_CONTS (1 << 7)
+#define CARRY (TOO_SHORT | TOO_LONG | TWO_CONTS)
+#define LANES(...) { __VA_ARGS__, __VA_ARGS__ }
+
+static const uint8_t byte_1_high[32] = LANES(
+    TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG, TOO_LONG,
+    TWO_CONTS, TWO_CONTS, TWO_CONTS, TWO_CONTS,
+    TOO_SHORT | OVERLONG_2,
+    TOO_SHORT,
+    TOO_SHORT | OVERLONG_3 | SURROGATE,
+    TOO_SHORT | TOO_LARGE | TOO_LARGE_1000 | OVERLONG_4);
+
+static const uint8_t byte_1_low[32] = LANES(
+    CARRY | OVERLONG_3 | OVERLONG_2 | OVERLONG_4,
+    CARRY | OVERLONG_2,
+    CARRY, CARRY,
+    CARRY | TOO_LARGE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000,
+    CARRY | TOO_LARGE | TOO_LARGE_1000 | SURROGATE,
+    CARRY | TOO_LARGE | TOO_LARGE_1000, CARRY | TOO_LARGE | TOO_LARGE_1000);
+
+static const uint8_t byte_2_high[32] = LANES(
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE_1000 | OVERLONG_4,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | OVERLONG_3 | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_LONG | OVERLONG_2 | TWO_CONTS | SURROGATE | TOO_LARGE,
+    TOO_SHORT, TOO_SHORT, TOO_SHORT, TOO_SHORT);
+
+// Son üç baytta başlayıp bloğun dışına taşan dizi var mı
+static const uint8_t incomplete_max[32] = {
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 0xef, 0xdf, 0xbf,
+};
+
+// x'in önüne bir önceki bloğun son n baytını kaydırır
+#define PREV(x, prev, n) _mm256_alignr_epi8((x), _mm256_permute2x128_si256((prev), (x), 0x21), 16 - (n))
+
+__attribute__((target("avx2")))
+static size_t clean_prefix_avx2(const unsigned char *s, size_t len) {
+    const __m256i high_1 = _mm256_loadu_si256((const __m256i *)byte_1_high);
+    const __m256i low_1 = _mm256_loadu_si256((const __m256i *)byte_1_low);
+    const __m256i high_2 = _mm256_loadu_si256((const __m256i *)byte_2_high);
+    const __m256i max = _mm256_loadu_si256((const __m256i *)incomplete_max);
+    const __m256i nibble = _mm256_set1_epi8(0x0f);
+    const __m256i control = _mm256_set1_epi8(0x1f);
+    const __m256i del = _mm256_set1_epi8(0x7f);
+    const __m256i newline = _mm256_set1_epi8('\n');
+    const __m256i tab = _mm256_set1_epi8('\t');
+    __m256i prev = _mm256_setzero_si256();
+    __m256i prev_incomplete = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i *)(s + i));
+        // Denetim karakteri (\t ve \n hariç), DEL ve ESC skaler yola kalır
+        __m256i special = _mm256_cmpeq_epi8(_mm256_min_epu8(x, control), x);
+        special = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, newline), _mm256_cmpeq_epi8(x, tab)), special);
+        special = _mm256_or_si256(special, _mm256_cmpeq_epi8(x, del));
+
+        __m256i error;
+        if (!_mm256_movemask_epi8(x)) {
+            error = prev_incomplete;
+            prev_incomplete = _mm256_setzero_si256();
+        } else {
+            __m256i prev1 = PREV(x, prev, 1);
+            __m256i sc = _mm256_and_si256(
+                _mm256_and_si256(_mm256_shuffle_epi8(high_1, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                                 _mm256_shuffle_epi8(low_1, _mm256_and_si256(prev1, nibble))),
+                _mm256_shuffle_epi8(high_2, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble)));
+            __m256i third = _mm256_subs_epu8(PREV(x, prev, 2), _mm256_set1_epi8((char)(0xe0 - 0x80)));
+            __m256i fourth = _mm256_subs_epu8(PREV(x, prev, 3), _mm256_set1_epi8((char)(0xf0 - 0x80)));
+            __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8((char)0x80));
+            error = _mm256_xor_si256(must23, sc);
+            prev_incomplete = _mm256_subs_epu8(x, max);
+        }
+        if (!_mm256_testz_si256(error, error) || !_mm256_testz_si256(special, special)) break;
+        prev = x;
+    }
+
+    // Doğrulanan bloklar [0, i); i'nin üstüne taşan dizinin başına geri dön
+    for (size_t k = 1; k <= 3 && k <= i; k++) {
+        unsigned char c = s[i - k];
+        if (c < 0x80) break;
+        if (c >= 0xc0) {
+            i -= k;
+            break;
+        }
+    }
+    return i + clean_prefix_scalar(s + i, len - i);
+}
+#endif
+
+typedef size_t (*PrefixScanner)(const unsigned char *s, size_t len);
+static PrefixScanner clean_prefix;
+static const char *selected_isa;
+
+// Kirli bölgede her baytın karşılığı: kendisi, hiçbir şey ya da U+FFFD.
+// Baş baytlarında need dizi uzunluğu, ikinci baytın aralığı [lo, lo + span]'dir
+// (bkz. decode); ikinci bayt aralık dışındaysa karşılık tek baytlık U+FFFD'dir.
+// Tek baytlarda aralık boş (span -1), ESC'de tamdır: yalnızca ESC ve ikinci
+// baytı geçerli başlangıçlar yavaş yola düşer.
+typedef struct {
+    unsigned char out[4];
+    uint8_t len;
+    uint8_t need;
+    uint8_t lo;
+    int16_t span;
+} ScrubEntry;
+
+static ScrubEntry scrub_table[256];
+
+static void scrub_init(void) {
+    for (int c = 0; c < 256; c++) {
+        ScrubEntry *e = &scrub_table[c];
+        e->need = 1;
+        e->span = -1;
+        if (is_plain((unsigned char)c)) {
+            e->out[0] = (unsigned char)c;
+            e->len = 1;
+        } else if (c == '\r' || c == 0x07 || c == 0x08) {
+            e->len = 0;
+        } else {
+            memcpy(e->out, replacement, 3);
+            e->len = 3;
+        }
+        if (c >= 0xc2 && c <= 0xf4) {
+            e->need = c < 0xe0 ? 2 : c < 0xf0 ? 3 : 4;
+            e->lo = c == 0xe0 ? 0xa0 : c == 0xf0 ? 0x90 : 0x80;
+            e->span = (c == 0xed ? 0x9f : c == 0xf4 ? 0x8f : 0xbf) - e->lo;
+        }
+    }
+    scrub_table[0x1b].need = 0;
+    scrub_table[0x1b].span = 0xff;
+}
+
+int sanitize_select(const char *isa) {
+    if (!scrub_table['a'].len) scrub_init();
+    if (!isa) isa = getenv("TERMINAL_SANITIZE");
+#ifdef SANITIZE_X86
+    __builtin_cpu_init();
+    int avx2 = __builtin_cpu_supports("avx2");
+    int sse2 = __builtin_cpu_supports("sse2");
+    if (!isa || !isa[0]) isa = avx2 ? "avx2" : sse2 ? "sse2" : "scalar";
+    if (strcmp(isa, "avx2") == 0 && avx2) {
+        clean_prefix = clean_prefix_avx2;
+    } else if (strcmp(isa, "sse2") == 0 && sse2) {
+        clean_prefix = clean_prefix_sse2;
+    } else if (strcmp(isa, "scalar") == 0) {
+        clean_prefix = clean_prefix_scalar;
+    } else {
+        if (!clean_prefix) sanitize_select("scalar");
+        return -1;
+    }
+#else
+    if (!isa || !isa[0]) isa = "scalar";
+    clean_prefix = clean_prefix_scalar;
+    if (strcmp(isa, "scalar") != 0) {
+        selected_isa = "scalar";
+        return -1;
+    }
+#endif
+    selected_isa = isa;
+    return 0;
+}
+
+const char *sanitize_isa(void) {
+    if (!clean_prefix) sanitize_select(NULL);
+    return selected_isa;
+}
+
+// 38;5;n ve 38;2;r;g;b biçimindeki genişletilmiş renkler
+static int32_t extended_color(const Sanitizer *s, int *i, int32_t current) {
+    const int *p = s->params;
+    int n = *i;
+    if (n + 2 < s->param_count && p[n + 1] == 5) {
+        *i = n + 2;
+        return p[n + 2] & 0xff;
+    }
+    if (n + 4 < s->param_count && p[n + 1] == 2) {
+        *i = n + 4;
+        int r = p[n + 2] > 255 ? 255 : p[n + 2];
+        int g = p[n + 3] > 255 ? 255 : p[n + 3];
+        int b = p[n + 4] > 255 ? 255 : p[n + 4];
+        return STYLE_RGB | r << 16 | g << 8 | b;
+    }
+    *i = s->param_count;
+    return current;
+}
+
+static void apply_sgr(Sanitizer *s, SanitizeCallback callback, void *user_data) {
+    TextStyle style = s->style;
+    for (int i = 0; i < s->param_count; i++) {
+        int p = s->params[i];
+        if (p == 0) {
+            style.fg = STYLE_DEFAULT;
+            style.bg = STYLE_DEFAULT;
+            style.flags = 0;
+        } else if (p == 1) style.flags |= STYLE_BOLD;
+        else if (p == 3) style.flags |= STYLE_ITALIC;
+        else if (p == 4) style.flags |= STYLE_UNDERLINE;
+        else if (p == 7) style.flags |= STYLE_INVERSE;
+        else if (p == 22) style.flags &= ~STYLE_BOLD;
+        else if (p == 23) style.flags &= ~STYLE_ITALIC;
+        else if (p == 24) style.flags &= ~STYLE_UNDERLINE;
+        else if (p == 27) style.flags &= ~STYLE_INVERSE;
+        else if (p >= 30 && p <= 37) style.fg = p - 30;
+        else if (p == 38) style.fg = extended_color(s, &i, style.fg);
+        else if (p == 39) style.fg = STYLE_DEFAULT;
+        else if (p >= 40 && p <= 47) style.bg = p - 40;
+        else if (p == 48) style.bg = extended_color(s, &i, style.bg);
+        else if (p == 49) style.bg = STYLE_DEFAULT;
+        else if (p >= 90 && p <= 97) style.fg = p - 90 + 8;
+        else if (p >= 100 && p <= 107) style.bg = p - 100 + 8;
+    }
+    if (style.fg == s->style.fg && style.bg == s->style.bg && style.flags == s->style.flags) return;
+    flush(s, callback, user_data);
+    s->style = style;
+}
+
+static inline void csi_start(Sanitizer *s) {
+    s->params[0] = 0;
+    s->param_count = 1;
+    s->private_csi = 0;
+}
+
+// CSI gövdesinin bir baytı; dizi bittiyse 1 döner
+static inline int csi_byte(Sanitizer *s, unsigned char c, SanitizeCallback callback, void *user_data) {
+    if (c >= '0' && c <= '9') {
+        int *p = &s->params[s->param_count - 1];
+        if (*p < 100000) *p = *p * 10 + (c - '0');
+    } else if (c == ';' || c == ':') {
+        if (s->param_count < SGR_MAX_PARAMS) s->params[s->param_count++] = 0;
+    } else if ((c >= 0x3c && c <= 0x3f) || (c >= 0x20 && c <= 0x2f)) {
+        s->private_csi = 1;
+    } else {
+        // Son bayt: yalnızca SGR uygulanır, imleç hareketi ve silme yok sayılır
+        if (c == 'm' && !s->private_csi) apply_sgr(s, callback, user_data);
+        return 1;
+    }
+    return 0;
+}
+
+// Tamamı elimizdeki CSI dizisini durum makinesine girmeden işler; tüketilen bayt ya da 0
+static size_t parse_csi(Sanitizer *s, const unsigned char *p, const unsigned char *end,
+                        SanitizeCallback callback, void *user_data) {
+    if (end - p < 3 || p[1] != '[') return 0;
+    csi_start(s);
+    for (const unsigned char *q = p + 2; q < end; q++) {
+        if (csi_byte(s, *q, callback, user_data)) return (size_t)(q + 1 - p);
+    }
+    return 0; // Parça içinde bitmedi: baştan durum makinesiyle işlenir
+}
+
+// Kaçış dizisinin bir baytı; diziler parçalar arasında bölünebilir
+static void escape_byte(Sanitizer *s, unsigned char c, SanitizeCallback callback, void *user_data) {
+    switch (s->state) {
+    case STATE_ESC:
+        if (c == '[') {
+            s->state = STATE_CSI;
+            csi_start(s);
+        } else if (c == ']') {
+            s->state = STATE_OSC;
+        } else if (c < 0x20 || c > 0x2f) {
+            s->state = STATE_TEXT; // ESC ( B gibi ara baytlar dışında iki baytlık dizi
+        }
+        break;
+    case STATE_CSI:
+        if (csi_byte(s, c, callback, user_data)) s->state = STATE_TEXT;
+        break;
+    case STATE_OSC:
+        // Pencere başlığı gibi işletim komutları BEL ya da ESC \ ile biter
+        if (c == 0x07) s->state = STATE_TEXT;
+        else if (c == 0x1b) s->state = STATE_OSC_ESC;
+        break;
+    case STATE_OSC_ESC:
+        s->state = c == '\\' ? STATE_TEXT : STATE_OSC;
+        break;
+    }
+}
+
+// Önceki parçadan kalan yarım diziyi tamamlar; tüketilen bayt sayısını döndürür
+static size_t finish_carry(Sanitizer *s, const unsigned char *p, size_t len) {
+    unsigned char seq[4];
+    size_t old = s->carry_len;
+    size_t take = len < 4 - old ? len : 4 - old;
+    memcpy(seq, s->carry, old);
+    memcpy(seq + old, p, take);
+    int n = decode(seq, old + take);
+    if (n == 0) {
+        memcpy(s->carry + old, p, take);
+        s->carry_len += take;
+        return take;
+    }
+    s->carry_len = 0;
+    if (n > 0) {
+        emit(s, seq, (size_t)n);
+        return (size_t)n - old;
+    }
+    emit_replacement(s);
+    return (size_t)-n - old;
+}
+
+// Temiz önekten sonraki kirli bölge. Baytların çoğunun karşılığı tek baytlıktır
+// (bayt, hiçbir şey ya da U+FFFD) ve tablodan 4 bayt olarak yazılıp uzunluğu kadar
+// ilerlenir. İkili veride baş baytlarının çoğu zaten ikinci baytta bozulur; dal
+// yalnızca ikinci bayt geçerliyse alınır, dizinin kalanı orada dalsız denetlenir.
+// ESC'de, son üç baytta (dizi taşabilir) ya da SHORT_RUN temiz baytta durur.
+static const unsigned char *scrub(Sanitizer *s, const unsigned char *p, const unsigned char *end) {
+    size_t avail = (size_t)(end - p) < SCRUB_MAX ? (size_t)(end - p) : SCRUB_MAX;
+    if (avail < 4) return p;
+    if (s->out_len + avail * 3 + 1 > s->out_cap && reserve(s, avail * 3 + 1) == -1) return p;
+    unsigned char *out = (unsigned char *)s->out + s->out_len;
+    const unsigned char *stop = p + avail - 3;
+    size_t run = 0;
+    while (p < stop) {
+        const ScrubEntry *e = &scrub_table[*p];
+        if (__builtin_expect((uint8_t)(p[1] - e->lo) > e->span, 1)) {
+            memcpy(out, e->out, 4);
+            out += e->len;
+            p++;
+            run = (run + 1) & -(size_t)(e->len == 1);
+        } else {
+            if (e->need == 0) break;
+            unsigned ok2 = (p[2] & 0xc0) == 0x80;
+            unsigned ok3 = ok2 & ((p[3] & 0xc0) == 0x80);
+            unsigned valid = (3u | ok2 << 2 | ok3 << 3) >> (e->need - 1) & 1;
+            // Seçimler maskeyle: derleyici koşullu ifadeleri dala çevirebiliyor
+            uint32_t mask = -(uint32_t)valid;
+            uint32_t bytes, mapped;
+            memcpy(&bytes, p, 4);
+            memcpy(&mapped, replacement, 4);
+            bytes = (bytes & mask) | (mapped & ~mask);
+            memcpy(out, &bytes, 4);
+            out += 3 ^ ((3 ^ e->need) & mask);
+            unsigned sub = 2 + ok2;
+            p += sub ^ ((sub ^ e->need) & mask);
+            run = (run + e->need) & -(size_t)valid;
+        }
+        if (run >= SHORT_RUN) break; // Uzun temiz koşu: vektör yoluna dön
+    }
+    s->out_len = (size_t)(out - (unsigned char *)s->out);
+    return p;
+}
+
+void sanitizer_feed(Sanitizer *s, const char *data, size_t len, SanitizeCallback callback, void *user_data) {
+    if (!clean_prefix) sanitize_select(NULL);
+    const unsigned char *p = (const unsigned char *)data;
+    const unsigned char *end = p + len;
+    if (s->carry_len && s->state == STATE_TEXT) p += finish_carry(s, p, len);
+
+    while (p < end) {
+        if (s->state != STATE_TEXT) {
+            escape_byte(s, *p++, callback, user_data);
+            continue;
+        }
+        // İkili veride koşular kısa: önce skaler bak, uzun koşuda vektör yoluna geç
+        size_t window = (size_t)(end - p) < SHORT_RUN ? (size_t)(end - p) : SHORT_RUN;
+        size_t n = clean_prefix_scalar(p, window);
+        if (n == window) n += clean_prefix(p + n, (size_t)(end - p) - n);
+        if (n) emit(s, p, n);
+        p += n;
+        if (p == end) break;
+        p = scrub(s, p, end);
+        if (p == end) break;
+
+        unsigned char c = *p;
+        if (is_plain(c)) continue; // scrub temiz koşuda durdu
+        if (c == 0x1b) {
+            size_t used = parse_csi(s, p, end, callback, user_data);
+            if (used) {
+                p += used;
+            } else {
+                s->state = STATE_ESC;
+                p++;
+            }
+        } else if (c < 0x80) {
+            // \r, zil ve geri silme gösterilmez; diğer denetim karakterleri görünür olsun
+            if (c != '\r' && c != 0x07 && c != 0x08) emit_replacement(s);
+            p++;
+        } else {
+            int r = decode(p, (size_t)(end - p));
+            if (r == 0) {
+                s->carry_len = (size_t)(end - p);
+                memcpy(s->carry, p, s->carry_len);
+                p = end;
+            } else if (r > 0) {
+                emit(s, p, (size_t)r);
+                p += r;
+            } else {
+                emit_replacement(s);
+                p += -r;
+            }
+        }
+    }
+    flush(s, callback, user_data);
+}
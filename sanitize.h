@@ -0,0 +1,33 @@
+#ifndef SANITIZE_H
+#define SANITIZE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Çocuk süreç çıktısını GTK'ya gitmeden önce temizler: geçersiz UTF-8 U+FFFD
+// olur, ANSI SGR kaçışları stile çevrilir, diğer kaçışlar ve denetim karakterleri atılır.
+#define STYLE_DEFAULT -1            // fg/bg için terminalin kendi rengi
+#define STYLE_RGB 0x1000000         // fg/bg: STYLE_RGB | 0xrrggbb, aksi halde 0-255 palet
+#define STYLE_BOLD 1
+#define STYLE_ITALIC 2
+#define STYLE_UNDERLINE 4
+#define STYLE_INVERSE 8
+
+typedef struct {
+    int32_t fg;
+    int32_t bg;
+    uint32_t flags;
+} TextStyle;
+
+typedef struct Sanitizer Sanitizer;
+typedef void (*SanitizeCallback)(const char *text, size_t len, const TextStyle *style, void *data);
+
+Sanitizer *sanitizer_new(void);
+void sanitizer_free(Sanitizer *sanitizer);
+void sanitizer_reset(Sanitizer *sanitizer);
+void sanitizer_feed(Sanitizer *sanitizer, const char *data, size_t len, SanitizeCallback callback, void *user_data);
+int style_is_default(const TextStyle *style);
+int sanitize_select(const char *isa);
+const char *sanitize_isa(void);
+
+#endif
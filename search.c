@@ -0,0 +1,194 @@
+#include "search.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Açık adreslemeli karma tablosu: her kelimenin artan sırada mesaj numarası
+// listesi var. Sorgu kelimelerin listelerini en kısadan başlayarak keser,
+// yani maliyet geçmişin boyutuyla değil en nadir kelimenin sıklığıyla artar.
+#define MAX_TERM 32
+#define MAX_QUERY_TERMS 8
+#define MIN_TERM 2
+
+typedef struct {
+    char term[MAX_TERM]; // Boş yuvada term[0] == '\0'
+    uint32_t hash;
+    uint32_t count;
+    uint32_t capacity;
+    uint64_t *ids;
+} Term;
+
+struct SearchIndex {
+    Term *terms;
+    size_t capacity; // İkinin kuvveti
+    size_t used;
+};
+
+SearchIndex *search_new(void) {
+    SearchIndex *index = malloc(sizeof(SearchIndex));
+    if (!index) return NULL;
+    index->capacity = 1024;
+    index->used = 0;
+    index->terms = calloc(index->capacity, sizeof(Term));
+    if (!index->terms) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+void search_free(SearchIndex *index) {
+    if (!index) return;
+    for (size_t i = 0; i < index->capacity; i++) free(index->terms[i].ids);
+    free(index->terms);
+    free(index);
+}
+
+static int is_word_char(unsigned char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c >= 0x80;
+}
+
+// Sıradaki kelimeyi küçük harfe çevirip out'a yazar; uzunluğunu döndürür, bitince 0.
+// Çok uzun kelimeler MAX_TERM - 1 baytta kesilir.
+static size_t next_token(const char **cursor, const char *end, char *out, uint32_t *hash) {
+    const unsigned char *p = (const unsigned char *)*cursor;
+    const unsigned char *e = (const unsigned char *)end;
+    for (;;) {
+        while (p < e && !is_word_char(*p)) p++;
+        if (p >= e) {
+            *cursor = (const char *)p;
+            return 0;
+        }
+        size_t len = 0;
+        uint32_t h = 2166136261u;
+        while (p < e && is_word_char(*p)) {
+            unsigned char c = *p++;
+            if (c >= 'A' && c <= 'Z') c += 'a' - 'A';
+            if (len < MAX_TERM - 1) {
+                out[len++] = (char)c;
+                h = (h ^ c) * 16777619u;
+            }
+        }
+        if (len < MIN_TERM) continue;
+        out[len] = '\0';
+        *hash = h;
+        *cursor = (const char *)p;
+        return len;
+    }
+}
+
+static Term *find_term(const SearchIndex *index, const char *term, uint32_t hash) {
+    size_t mask = index->capacity - 1;
+    for (size_t i = hash & mask;; i = (i + 1) & mask) {
+        Term *slot = &index->terms[i];
+        if (!slot->term[0]) return slot;
+        if (slot->hash == hash && strcmp(slot->term, term) == 0) return slot;
+    }
+}
+
+static int grow(SearchIndex *index) {
+    Term *old = index->terms;
+    size_t old_capacity = index->capacity;
+    Term *terms = calloc(old_capacity * 2, sizeof(Term));
+    if (!terms) return -1;
+    index->terms = terms;
+    index->capacity = old_capacity * 2;
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old[i].term[0]) *find_term(index, old[i].term, old[i].hash) = old[i];
+    }
+    free(old);
+    return 0;
+}
+
+// Listeye sıralı ekler; mesajlar neredeyse sırayla geldiği için genelde sona eklenir
+static void add_posting(Term *term, uint64_t id) {
+    uint32_t pos = term->count;
+    while (pos > 0 && term->ids[pos - 1] > id) pos--;
+    if (pos > 0 && term->ids[pos - 1] == id) return;
+    if (term->count == term->capacity) {
+        uint32_t capacity = term->capacity ? term->capacity * 2 : 4;
+        uint64_t *ids = realloc(term->ids, capacity * sizeof(uint64_t));
+        if (!ids) return;
+        term->ids = ids;
+        term->capacity = capacity;
+    }
+    memmove(term->ids + pos + 1, term->ids + pos, (term->count - pos) * sizeof(uint64_t));
+    term->ids[pos] = id;
+    term->count++;
+}
+
+void search_add(SearchIndex *index, uint64_t id, const char *text, size_t len) {
+    const char *cursor = text;
+    const char *end = text + len;
+    char token[MAX_TERM];
+    uint32_t hash;
+    while (next_token(&cursor, end, token, &hash)) {
+        if ((index->used + 1) * 10 > index->capacity * 7 && grow(index) == -1) return;
+        Term *term = find_term(index, token, hash);
+        if (!term->term[0]) {
+            memcpy(term->term, token, MAX_TERM);
+            term->hash = hash;
+            index->used++;
+        }
+        add_posting(term, id);
+    }
+}
+
+// Azalan sırada ilerleyen imleç: *pos'tan önceki ilk id'si <= id olan konuma
+// üstel adımlarla yaklaşıp ikili aramayla bitirir (galloping). Eşleşme varsa 1.
+static int seek_back(const Term *term, uint32_t *pos, uint64_t id) {
+    uint32_t hi = *pos;
+    uint32_t step = 1;
+    while (step <= hi && term->ids[hi - step] > id) step *= 2;
+    uint32_t lo = step <= hi ? hi - step : 0;
+    hi = hi - step / 2;
+    // term->ids[hi..] > id; ikili arama ile [lo, hi) içinde son <= id'yi bul
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        if (term->ids[mid] > id) hi = mid;
+        else lo = mid + 1;
+    }
+    *pos = lo;
+    return lo > 0 && term->ids[lo - 1] == id;
+}
+
+// Tüm kelimeleri içeren mesajları en yeniden eskiye results'a yazar (en fazla
+// max_results tane) ve toplam eşleşme sayısını döndürür
+size_t search_query(const SearchIndex *index, const char *query, uint64_t *results, size_t max_results) {
+    const Term *terms[MAX_QUERY_TERMS];
+    size_t term_count = 0;
+    const char *cursor = query;
+    const char *end = query + strlen(query);
+    char token[MAX_TERM];
+    uint32_t hash;
+    while (term_count < MAX_QUERY_TERMS && next_token(&cursor, end, token, &hash)) {
+        const Term *term = find_term(index, token, hash);
+        if (!term->term[0]) return 0;
+        terms[term_count++] = term;
+    }
+    if (term_count == 0) return 0;
+
+    // En nadir kelime önce
+    for (size_t i = 1; i < term_count; i++) {
+        for (size_t j = i; j > 0 && terms[j]->count < terms[j - 1]->count; j--) {
+            const Term *tmp = terms[j];
+            terms[j] = terms[j - 1];
+            terms[j - 1] = tmp;
+        }
+    }
+
+    // Her kelime için geriye doğru ilerleyen bir imleç; listeler bir kez taranır
+    uint32_t cursors[MAX_QUERY_TERMS];
+    for (size_t t = 0; t < term_count; t++) cursors[t] = terms[t]->count;
+
+    size_t total = 0;
+    const Term *rarest = terms[0];
+    for (uint32_t i = rarest->count; i > 0; i--) {
+        uint64_t id = rarest->ids[i - 1];
+        size_t t = 1;
+        while (t < term_count && seek_back(terms[t], &cursors[t], id)) t++;
+        if (t < term_count) continue;
+        if (total < max_results) results[total] = id;
+        total++;
+    }
+    return total;
+}
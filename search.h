@@ -0,0 +1,15 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Mesaj numaralarını kelimelere göre tutan artımlı ters dizin
+typedef struct SearchIndex SearchIndex;
+
+SearchIndex *search_new(void);
+void search_free(SearchIndex *index);
+void search_add(SearchIndex *index, uint64_t id, const char *text, size_t len);
+size_t search_query(const SearchIndex *index, const char *query, uint64_t *results, size_t max_results);
+
+#endif
@@ -0,0 +1,87 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <spawn.h>
+#include <string.h>
+#include <unistd.h>
+#include "spawner.h"
+
+#define MAX_OPEN_REDIRECTS 16
+
+extern char **environ;
+
+void spawn_request_init(SpawnRequest *req) {
+    memset(req, 0, sizeof(*req));
+    req->stdin_fd = -1;
+    req->stdout_fd = -1;
+    req->stderr_fd = -1;
+}
+
+// Dosya yönlendirmeleri üst süreçte açılır: posix_spawn'ın kendi open'ı
+// başarısız olsa hata exec'inkinden ayırt edilemezdi ("komut bulunamadı" olurdu)
+static int open_redirect(const Redirect *r) {
+    int flags = r->type == REDIRECT_IN ? O_RDONLY
+              : r->type == REDIRECT_OUT ? O_WRONLY | O_CREAT | O_TRUNC
+                                        : O_WRONLY | O_CREAT | O_APPEND;
+    return open(r->target, flags | O_CLOEXEC, 0644);
+}
+
+// posix_spawn glibc'de CLONE_VFORK kullanır: üst sürecin adres alanı
+// kopyalanmaz, bu yüzden maliyet GTK yığınının boyutundan bağımsızdır.
+// Yönlendirme dosyası açılamazsa -1 döner, errno open'ınkidir ve
+// failed_redirect verilmişse o yönlendirmeyi gösterir.
+pid_t spawn_process(const SpawnRequest *req) {
+    posix_spawn_file_actions_t actions;
+    posix_spawnattr_t attr;
+    int opened[MAX_OPEN_REDIRECTS];
+    int opened_count = 0;
+    pid_t pid;
+    int err = 0;
+
+    if (!req->argv && !req->shell_command) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    posix_spawn_file_actions_init(&actions);
+    posix_spawnattr_init(&attr);
+#ifdef POSIX_SPAWN_USEVFORK
+    posix_spawnattr_setflags(&attr, POSIX_SPAWN_USEVFORK);
+#endif
+
+    if (req->stdin_fd >= 0) posix_spawn_file_actions_adddup2(&actions, req->stdin_fd, STDIN_FILENO);
+    if (req->stdout_fd >= 0) posix_spawn_file_actions_adddup2(&actions, req->stdout_fd, STDOUT_FILENO);
+    if (req->stderr_fd >= 0) posix_spawn_file_actions_adddup2(&actions, req->stderr_fd, STDERR_FILENO);
+
+    // Yönlendirmeler boruların üzerine yazar; shell yolunda bunu sh yapar
+    if (req->argv) {
+        for (const Redirect *r = req->redirects; r && !err; r = r->next) {
+            if (r->type == REDIRECT_DUP) {
+                posix_spawn_file_actions_adddup2(&actions, r->dup_fd, r->fd);
+                continue;
+            }
+            int fd = -1;
+            if (opened_count < MAX_OPEN_REDIRECTS) fd = open_redirect(r);
+            else errno = EMFILE;
+            if (fd < 0) {
+                err = errno;
+                if (req->failed_redirect) *req->failed_redirect = r;
+                break;
+            }
+            opened[opened_count++] = fd;
+            posix_spawn_file_actions_adddup2(&actions, fd, r->fd);
+        }
+        if (!err) err = posix_spawnp(&pid, req->argv[0], &actions, &attr, req->argv, environ);
+    } else {
+        char *const sh_argv[] = { "sh", "-c", (char *)req->shell_command, NULL };
+        err = posix_spawn(&pid, "/bin/sh", &actions, &attr, sh_argv, environ);
+    }
+
+    for (int i = 0; i < opened_count; i++) close(opened[i]);
+    posix_spawnattr_destroy(&attr);
+    posix_spawn_file_actions_destroy(&actions);
+    if (err != 0) {
+        errno = err;
+        return -1;
+    }
+    return pid;
+}
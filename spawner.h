@@ -0,0 +1,23 @@
+#ifndef SPAWNER_H
+#define SPAWNER_H
+
+#include <stddef.h>
+#include <sys/types.h>
+#include "parser.h"
+
+// Bir süreci başlatmak için gereken her şey. argv verilirse doğrudan exec
+// edilir, verilmezse shell_command "sh -c" ile çalıştırılır (yönlendirmeleri sh yapar).
+typedef struct {
+    char *const *argv;
+    const char *shell_command;
+    const Redirect *redirects; // Borulardan sonra sırayla uygulanır
+    const Redirect **failed_redirect; // Açılamayan dosya yönlendirmesi buraya yazılır (NULL olabilir)
+    int stdin_fd;              // -1 ise miras alınır
+    int stdout_fd;
+    int stderr_fd;
+} SpawnRequest;
+
+void spawn_request_init(SpawnRequest *req);
+pid_t spawn_process(const SpawnRequest *req);
+
+#endif
@@ -0,0 +1,187 @@
+#include "stats.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// Log-doğrusal kovalar: 32'den küçük değerler tam, üstünde her ikinin
+// kuvveti aralığı 32 eşit parçaya bölünür. Kayıt O(1), göreli hata en fazla
+// 1/32 ve 1 ns'den 2^64'e kadar her değer sabit 15 KB'a sığar.
+#define SUB_BITS 5
+#define SUB_COUNT (1 << SUB_BITS)
+#define BUCKET_COUNT ((64 - SUB_BITS + 1) * SUB_COUNT)
+
+typedef struct {
+    uint64_t count;
+    uint64_t min;
+    uint64_t max;
+    double sum;
+    uint64_t buckets[BUCKET_COUNT];
+} Histogram;
+
+struct Stats {
+    uint64_t processes;
+    time_t since;
+    Histogram metrics[STAT_COUNT];
+};
+
+static const struct {
+    const char *name;
+    int is_time; // 0 ise KB
+} metric_info[STAT_COUNT] = {
+    [STAT_SPAWN] = { "spawn", 1 },         [STAT_FIRST_BYTE] = { "first_byte", 1 },
+    [STAT_READ] = { "read", 1 },           [STAT_RUNTIME] = { "runtime", 1 },
+    [STAT_RENDER] = { "render", 1 },       [STAT_TOTAL] = { "total", 1 },
+    [STAT_CPU_USER] = { "cpu_user", 1 },   [STAT_CPU_SYS] = { "cpu_sys", 1 },
+    [STAT_MAX_RSS] = { "max_rss", 0 },
+};
+
+static int bucket_index(uint64_t value) {
+    if (value < SUB_COUNT) return (int)value;
+    int shift = 63 - __builtin_clzll(value) - SUB_BITS;
+    return (shift + 1) * SUB_COUNT + (int)((value >> shift) & (SUB_COUNT - 1));
+}
+
+// Kovanın orta noktası; yüzdelikler bununla raporlanır
+static uint64_t bucket_value(int index) {
+    if (index < SUB_COUNT) return (uint64_t)index;
+    int shift = index / SUB_COUNT - 1;
+    uint64_t low = (uint64_t)(SUB_COUNT + index % SUB_COUNT) << shift;
+    return low + ((1ull << shift) >> 1);
+}
+
+static void histogram_reset(Histogram *h) {
+    memset(h, 0, sizeof(*h));
+    h->min = UINT64_MAX;
+}
+
+static uint64_t histogram_percentile(const Histogram *h, double percentile) {
+    if (h->count == 0) return 0;
+    uint64_t rank = (uint64_t)(percentile / 100.0 * (double)h->count + 0.5);
+    if (rank < 1) rank = 1;
+    if (rank > h->count) rank = h->count;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        seen += h->buckets[i];
+        if (seen >= rank) {
+            uint64_t value = bucket_value(i);
+            if (value < h->min) value = h->min;
+            return value > h->max ? h->max : value;
+        }
+    }
+    return h->max;
+}
+
+Stats *stats_new(void) {
+    Stats *stats = malloc(sizeof(Stats));
+    if (!stats) return NULL;
+    stats_reset(stats);
+    return stats;
+}
+
+void stats_free(Stats *stats) {
+    free(stats);
+}
+
+void stats_reset(Stats *stats) {
+    stats->processes = 0;
+    stats->since = time(NULL);
+    for (int i = 0; i < STAT_COUNT; i++) histogram_reset(&stats->metrics[i]);
+}
+
+void stats_record(Stats *stats, StatMetric metric, uint64_t value) {
+    Histogram *h = &stats->metrics[metric];
+    h->buckets[bucket_index(value)]++;
+    h->count++;
+    h->sum += (double)value;
+    if (value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+}
+
+void stats_count_process(Stats *stats) {
+    stats->processes++;
+}
+
+uint64_t stats_percentile(const Stats *stats, StatMetric metric, double percentile) {
+    return histogram_percentile(&stats->metrics[metric], percentile);
+}
+
+// Süreyi okunur birime çevirir: 850ns, 12.4us, 3.10ms, 1.20s
+static const char *format_value(char *buf, size_t size, double value, int is_time) {
+    if (!is_time) {
+        if (value >= 1024 * 1024) snprintf(buf, size, "%.1fGB", value / (1024 * 1024));
+        else if (value >= 1024) snprintf(buf, size, "%.1fMB", value / 1024);
+        else snprintf(buf, size, "%.0fKB", value);
+    } else if (value >= 1e9) {
+        snprintf(buf, size, "%.2fs", value / 1e9);
+    } else if (value >= 1e6) {
+        snprintf(buf, size, "%.2fms", value / 1e6);
+    } else if (value >= 1e3) {
+        snprintf(buf, size, "%.1fus", value / 1e3);
+    } else {
+        snprintf(buf, size, "%.0fns", value);
+    }
+    return buf;
+}
+
+void stats_print(const Stats *stats, FILE *out) {
+    static const double percentiles[] = { 50, 90, 99, 99.9 };
+    char since[32];
+    strftime(since, sizeof(since), "%Y-%m-%d %H:%M:%S", localtime(&stats->since));
+    fprintf(out, "%llu processes since %s\n", (unsigned long long)stats->processes, since);
+    fprintf(out, "%-10s %7s %9s %9s %9s %9s %9s %9s\n", "metric", "count", "p50", "p90", "p99", "p99.9", "max",
+            "mean");
+    for (int m = 0; m < STAT_COUNT; m++) {
+        const Histogram *h = &stats->metrics[m];
+        if (h->count == 0) continue;
+        char buf[16];
+        fprintf(out, "%-10s %7llu", metric_info[m].name, (unsigned long long)h->count);
+        for (size_t i = 0; i < sizeof(percentiles) / sizeof(percentiles[0]); i++) {
+            double value = (double)histogram_percentile(h, percentiles[i]);
+            fprintf(out, " %9s", format_value(buf, sizeof(buf), value, metric_info[m].is_time));
+        }
+        fprintf(out, " %9s", format_value(buf, sizeof(buf), (double)h->max, metric_info[m].is_time));
+        fprintf(out, " %9s\n", format_value(buf, sizeof(buf), h->sum / (double)h->count, metric_info[m].is_time));
+    }
+}
+
+// Panolar için JSON: özet değerler ve boş olmayan kovalar ([orta nokta, adet]),
+// böylece farklı oturumların histogramları birleştirilebilir.
+// Yarım dosya okunmasın diye geçici dosyaya yazılıp yeniden adlandırılır.
+int stats_export(const Stats *stats, const char *path) {
+    char tmp[4096];
+    snprintf(tmp, sizeof(tmp), "%s.%d.tmp", path, (int)getpid());
+    FILE *f = fopen(tmp, "w");
+    if (!f) return -1;
+    fprintf(f, "{\"since\": %lld, \"time\": %lld, \"processes\": %llu, \"metrics\": {", (long long)stats->since,
+            (long long)time(NULL), (unsigned long long)stats->processes);
+    for (int m = 0; m < STAT_COUNT; m++) {
+        const Histogram *h = &stats->metrics[m];
+        fprintf(f, "%s\n  \"%s\": {\"unit\": \"%s\", \"count\": %llu", m ? "," : "", metric_info[m].name,
+                metric_info[m].is_time ? "ns" : "KB", (unsigned long long)h->count);
+        if (h->count > 0) {
+            fprintf(f, ", \"min\": %llu, \"max\": %llu, \"mean\": %.0f, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, "
+                       "\"p999\": %llu",
+                    (unsigned long long)h->min, (unsigned long long)h->max, h->sum / (double)h->count,
+                    (unsigned long long)histogram_percentile(h, 50), (unsigned long long)histogram_percentile(h, 90),
+                    (unsigned long long)histogram_percentile(h, 99),
+                    (unsigned long long)histogram_percentile(h, 99.9));
+        }
+        fprintf(f, ", \"buckets\": [");
+        int first = 1;
+        for (int i = 0; i < BUCKET_COUNT; i++) {
+            if (!h->buckets[i]) continue;
+            fprintf(f, "%s[%llu, %llu]", first ? "" : ", ", (unsigned long long)bucket_value(i),
+                    (unsigned long long)h->buckets[i]);
+            first = 0;
+        }
+        fprintf(f, "]}");
+    }
+    fprintf(f, "\n}}\n");
+    if (fclose(f) != 0 || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
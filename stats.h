@@ -0,0 +1,33 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// Komut başına gecikme ve kaynak ölçümlerinin HDR tarzı histogramları.
+// Süreler nanosaniye, bellek KB olarak kaydedilir.
+typedef enum {
+    STAT_SPAWN,      // posix_spawn çağrısı (fork + exec)
+    STAT_FIRST_BYTE, // Başlatmadan ilk çıktı baytına
+    STAT_READ,       // İlk bayttan borudaki EOF'a
+    STAT_RUNTIME,    // Başlatmadan çıkışa
+    STAT_RENDER,     // EOF'tan çıktının görünüme verilmesine
+    STAT_TOTAL,      // Başlatmadan her şeyin bitmesine
+    STAT_CPU_USER,
+    STAT_CPU_SYS,
+    STAT_MAX_RSS,
+    STAT_COUNT
+} StatMetric;
+
+typedef struct Stats Stats;
+
+Stats *stats_new(void);
+void stats_free(Stats *stats);
+void stats_record(Stats *stats, StatMetric metric, uint64_t value);
+void stats_count_process(Stats *stats);
+void stats_reset(Stats *stats);
+uint64_t stats_percentile(const Stats *stats, StatMetric metric, double percentile);
+void stats_print(const Stats *stats, FILE *out);
+int stats_export(const Stats *stats, const char *path);
+
+#endif
@@ -1,65 +1,195 @@
 #include "view.h"
+#include <glib-unix.h>
+#include <gtk/gtk.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include "controller.h"
+#include "log.h"
+#include "sanitize.h"
+
+#define SCROLLBACK_LINES 10000 // Çıktı bölmesinde tutulan satır sayısı (TERMINAL_SCROLLBACK ile değişir)
+
+struct View {
+    GtkWidget *window;
+    GtkWidget *output_text;
+    GtkWidget *message_text;
+    GtkWidget *entry;
+    GtkWidget *status;
+    gchar *history_prefix;   // Gezinme başladığında yazılı olan metin (NULL = gezinmiyor)
+    guint64 history_pos;     // Girişte gösterilen geçmiş komutunun numarası
+    gboolean history_search; // Ctrl-R araması sürüyor
+    int scrollback_lines;
+    int scrollback_chunk;    // Sınırın bu kadar üstüne çıkınca baştan toplu silinir
+    Sanitizer *sanitizer;    // Çıktı akışının UTF-8 ve ANSI durumu (parçalar arası)
+    void (*on_command)(const char *input, void *data);
+    void *controller;
+};
+
+static void history_reset(View *view) {
+    g_free(view->history_prefix);
+    view->history_prefix = NULL;
+    if (view->history_search) gtk_label_set_text(GTK_LABEL(view->status), "Ready");
+    view->history_search = FALSE;
+}
+
+static void history_show(View *view, const char *text) {
+    gtk_entry_set_text(GTK_ENTRY(view->entry), text);
+    gtk_editable_set_position(GTK_EDITABLE(view->entry), -1);
+}
+
+// Up: yazılı önekle başlayan bir önceki komut, Ctrl-R: metni herhangi bir yerinde
+// içeren bir önceki; Down: bir sonraki, en sonda yazılı metin geri gelir
+static void history_step(View *view, int older, gboolean search) {
+    History *history = ((Controller *)view->controller)->model->history;
+    if (!history) return;
+    if (!view->history_prefix) {
+        view->history_prefix = g_strdup(gtk_entry_get_text(GTK_ENTRY(view->entry)));
+        view->history_pos = history_end(history);
+    }
+    view->history_search = view->history_search || search;
+
+    int64_t seq;
+    if (view->history_search) {
+        seq = older ? history_search_prev(history, view->history_prefix, view->history_pos)
+                    : history_search_next(history, view->history_prefix, view->history_pos);
+    } else {
+        seq = older ? history_prev(history, view->history_prefix, view->history_pos)
+                    : history_next(history, view->history_prefix, view->history_pos);
+    }
+    if (seq >= 0) {
+        view->history_pos = (guint64)seq;
+        history_show(view, history_at(history, (uint64_t)seq));
+    } else if (!older) {
+        view->history_pos = history_end(history);
+        history_show(view, view->history_prefix);
+    }
+
+    if (view->history_search) {
+        char status[MAX_COMMAND + 48];
+        snprintf(status, sizeof(status), "(reverse-i-search)`%s'%s", view->history_prefix,
+                 seq < 0 && older ? " (no more matches)" : "");
+        gtk_label_set_text(GTK_LABEL(view->status), status);
+    }
+}
+
+static gboolean on_entry_key_press(GtkWidget *widget, GdkEventKey *event, gpointer data) {
+    View *view = (View *)data;
+    if (event->keyval == GDK_KEY_Up) {
+        history_step(view, 1, FALSE);
+        return TRUE;
+    }
+    if (event->keyval == GDK_KEY_Down) {
+        if (view->history_prefix) history_step(view, 0, FALSE);
+        return TRUE;
+    }
+    if (event->keyval == GDK_KEY_r && (event->state & GDK_CONTROL_MASK)) {
+        history_step(view, 1, TRUE);
+        return TRUE;
+    }
+    if (event->keyval == GDK_KEY_Escape && view->history_prefix) {
+        history_show(view, view->history_prefix);
+        history_reset(view);
+        return TRUE;
+    }
+    // Başka bir tuş bulunan komutu düzenlemeye başlar
+    if (view->history_prefix) history_reset(view);
+    return FALSE;
+}
 
 static void on_entry_activate(GtkEntry *entry, gpointer data) {
     View *view = (View *)data;
+    history_reset(view);
     const char *input = gtk_entry_get_text(entry);
-    printf("Entry activated with input: %s\n", input);
+    LOG_DEBUG(LOG_VIEW, "Entry activated with input: %s", input);
     view->on_command(input, view->controller);
     gtk_entry_set_text(entry, "");
 }
 
-static gboolean update_messages(gpointer data) {
+// Gönderen adının özetiyle paletten renk seçilir; etiket ilk mesajda oluşturulur
+static const char *const sender_palette[] = {
+    "#ff5555", "#55ff55", "#5599ff", "#ffcc44", "#ff66cc", "#44dddd",
+    "#ff8844", "#aa88ff", "#99dd44", "#ff9999", "#66bbaa", "#dddddd",
+};
+
+static GtkTextTag *sender_tag(GtkTextBuffer *buffer, const char *sender) {
+    char tag_name[3 * MAX_USERNAME + 8]; // Onarılan her bayt U+FFFD (3 bayt) olabilir
+    snprintf(tag_name, sizeof(tag_name), "sender:%s", sender);
+    GtkTextTag *tag = gtk_text_tag_table_lookup(gtk_text_buffer_get_tag_table(buffer), tag_name);
+    if (tag) return tag;
+
+    uint32_t hash = 2166136261u;
+    for (const char *p = sender; *p; p++) hash = (hash ^ (unsigned char)*p) * 16777619u;
+    size_t count = sizeof(sender_palette) / sizeof(sender_palette[0]);
+    return gtk_text_buffer_create_tag(buffer, tag_name, "foreground", sender_palette[hash % count], NULL);
+}
+
+// Satır sayısı sınırı bir parça kadar aşınca fazlalık baştan tek seferde silinir;
+// silme maliyeti eklenen satırlara dağıldığı için oturum uzadıkça artmaz
+static void trim_scrollback(View *view, GtkTextBuffer *buffer) {
+    int lines = gtk_text_buffer_get_line_count(buffer);
+    if (lines <= view->scrollback_lines + view->scrollback_chunk) return;
+    GtkTextIter start, cut;
+    gtk_text_buffer_get_start_iter(buffer, &start);
+    gtk_text_buffer_get_iter_at_line(buffer, &cut, lines - view->scrollback_lines);
+    gtk_text_buffer_delete(buffer, &start, &cut);
+}
+
+// Tek bir mesajı doğru etiketle mesaj bölmesinin sonuna ekler
+static void append_message(const MessageEntry *entry, void *data) {
     View *view = (View *)data;
-    Controller *ctrl = (Controller *)view->controller;
-    char buffer[BUF_SIZE * MAX_HISTORY];
-    model_read_messages(ctrl->model, buffer, sizeof(buffer));
+    GtkTextBuffer *msg_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view->message_text));
+    GtkTextIter end;
+    gtk_text_buffer_get_end_iter(msg_buffer, &end);
 
-    size_t len = strlen(buffer);
-    while (len > 0 && buffer[len - 1] == '\n') {
-        buffer[len - 1] = '\0';
-        len--;
-    }
+    // Halkadaki metin başka süreçten gelir; strnlen kesmesi çok baytlı bir
+    // karakteri bölmüş olabilir, GTK'ya yalnızca geçerli UTF-8 verilir
+    gchar *sender = g_utf8_make_valid(entry->sender, -1);
+    GtkTextTag *tag = sender_tag(msg_buffer, sender);
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&entry->timestamp));
 
-    if (buffer[0] != '\0' && strcmp(buffer, view->last_message) != 0) {
-        char buffer_copy[BUF_SIZE * MAX_HISTORY];
-        strncpy(buffer_copy, buffer, sizeof(buffer_copy) - 1);
-        buffer_copy[sizeof(buffer_copy) - 1] = '\0';
-
-        GtkTextBuffer *msg_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view->message_text));
-        gtk_text_buffer_set_text(msg_buffer, "", -1);
-        GtkTextIter end;
-        gtk_text_buffer_get_end_iter(msg_buffer, &end);
-
-        char *line = strtok(buffer_copy, "\n");
-        while (line != NULL && line[0] != '\0') {
-            char sender[MAX_USERNAME];
-            char timestamp[32];
-            char content[BUF_SIZE];
-            if (sscanf(line, "[%[^]]] [%[^]]] %[^\n]", sender, timestamp, content) == 3) {
-                const char *tag_name = (strcmp(sender, "User1") == 0) ? "user1" : "user2";
-                char formatted_line[BUF_SIZE];
-                // content'ın uzunluğunu sınırlandır
-                int max_content_len = BUF_SIZE - (strlen(sender) + strlen(timestamp) + 10); // 10: sabit karakterler için
-                if (max_content_len < 0) max_content_len = 0;
-                snprintf(formatted_line, sizeof(formatted_line), "[%s] [%s] %.*s", 
-                         sender, timestamp, max_content_len, content);
-                gtk_text_buffer_insert_with_tags_by_name(msg_buffer, &end, formatted_line, -1, tag_name, NULL);
-                gtk_text_buffer_insert(msg_buffer, &end, "\n", -1);
-            } else if (sscanf(line, "[%[^]]] File: %[^\n]", sender, content) == 2) {
-                const char *tag_name = (strcmp(sender, "User1") == 0) ? "user1" : "user2";
-                gtk_text_buffer_insert_with_tags_by_name(msg_buffer, &end, line, -1, tag_name, NULL);
-                gtk_text_buffer_insert(msg_buffer, &end, "\n", -1);
-            }
-            line = strtok(NULL, "\n");
+    if (entry->type == 0) {
+        gchar *header = g_strdup_printf("[%s] [%s] ", sender, timestamp);
+        gchar *text = g_utf8_make_valid(entry->data, (gssize)entry->data_size);
+        gtk_text_buffer_insert_with_tags(msg_buffer, &end, header, -1, tag, NULL);
+        gtk_text_buffer_insert_with_tags(msg_buffer, &end, text, -1, tag, NULL);
+        g_free(text);
+        g_free(header);
+    } else {
+        gchar *filename = g_utf8_make_valid(entry->filename, -1);
+        gchar *line;
+        if (entry->compressed) {
+            line = g_strdup_printf("[%s] File: %s (%llu bytes, %llu compressed, id %llu)", sender, filename,
+                                   (unsigned long long)entry->file_size, (unsigned long long)entry->stored_size,
+                                   (unsigned long long)entry->seq);
+        } else {
+            line = g_strdup_printf("[%s] File: %s (%llu bytes, id %llu)", sender, filename,
+                                   (unsigned long long)entry->file_size, (unsigned long long)entry->seq);
         }
-        strncpy(view->last_message, buffer, sizeof(view->last_message) - 1);
-        view->last_message[sizeof(view->last_message) - 1] = '\0';
-        printf("Updated UI with: %s\n", buffer);
+        gtk_text_buffer_insert_with_tags(msg_buffer, &end, line, -1, tag, NULL);
+        g_free(line);
+        g_free(filename);
     }
-    return TRUE;
+    g_free(sender);
+    gtk_text_buffer_insert(msg_buffer, &end, "\n", -1);
+    trim_scrollback(view, msg_buffer);
+}
+
+static void update_messages(View *view) {
+    Controller *ctrl = (Controller *)view->controller;
+    int count = model_read_messages(ctrl->model, append_message, view);
+    if (count > 0) LOG_DEBUG(LOG_VIEW, "Appended %d messages to UI", count);
+}
+
+// Model'in eventfd'si yeni mesaj yayınlandığında okunabilir olur
+static gboolean on_message_ready(gint fd, GIOCondition condition, gpointer data) {
+    View *view = (View *)data;
+    Controller *ctrl = (Controller *)view->controller;
+    model_message_ack(ctrl->model);
+    update_messages(view);
+    return G_SOURCE_CONTINUE;
 }
 
 View *view_init(void (*on_command)(const char *input, void *data), void *controller) {
@@ -71,10 +201,17 @@ View *view_init(void (*on_command)(const char *input, void *data), void *control
     }
     view->on_command = on_command;
     view->controller = controller;
-    view->last_message[0] = '\0';
+    view->history_prefix = NULL;
+    view->history_pos = 0;
+    view->history_search = FALSE;
+    const char *scrollback = getenv("TERMINAL_SCROLLBACK");
+    view->scrollback_lines = scrollback && atoi(scrollback) > 0 ? atoi(scrollback) : SCROLLBACK_LINES;
+    view->scrollback_chunk = view->scrollback_lines / 8 > 64 ? view->scrollback_lines / 8 : 64;
+    view->sanitizer = sanitizer_new();
 
     view->window = gtk_window_new(GTK_WINDOW_TOPLEVEL);
-    gtk_window_set_title(GTK_WINDOW(view->window), "");
+    // Çok pencereli kullanımda hangi kullanıcı olduğu başlıkta görünsün
+    gtk_window_set_title(GTK_WINDOW(view->window), ((Controller *)controller)->model->username);
     gtk_window_set_default_size(GTK_WINDOW(view->window), 700, 500);
     g_signal_connect(view->window, "destroy", G_CALLBACK(gtk_main_quit), NULL);
 
@@ -150,47 +287,129 @@ View *view_init(void (*on_command)(const char *input, void *data), void *control
     gtk_container_add(GTK_CONTAINER(message_scrolled), view->message_text);
     gtk_box_pack_start(GTK_BOX(vbox), message_scrolled, TRUE, TRUE, 0);
 
-    GtkTextBuffer *msg_buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view->message_text));
-    gtk_text_buffer_create_tag(msg_buffer, "user1", "foreground", "#ff5555", NULL);
-    gtk_text_buffer_create_tag(msg_buffer, "user2", "foreground", "#55ff55", NULL);
-
     GtkWidget *entry_label = gtk_label_new("Enter Command");
     gtk_box_pack_start(GTK_BOX(vbox), entry_label, FALSE, FALSE, 0);
     view->entry = gtk_entry_new();
     gtk_entry_set_placeholder_text(GTK_ENTRY(view->entry), "Type here...");
     g_signal_connect(view->entry, "activate", G_CALLBACK(on_entry_activate), view);
+    g_signal_connect(view->entry, "key-press-event", G_CALLBACK(on_entry_key_press), view);
     gtk_box_pack_start(GTK_BOX(vbox), view->entry, FALSE, FALSE, 0);
 
-    GtkWidget *status_bar = gtk_label_new("Ready");
-    gtk_box_pack_start(GTK_BOX(vbox), status_bar, FALSE, FALSE, 0);
+    view->status = gtk_label_new("Ready");
+    gtk_box_pack_start(GTK_BOX(vbox), view->status, FALSE, FALSE, 0);
 
     gtk_widget_show_all(view->window);
-    g_timeout_add(500, update_messages, view);
+    // Halkada duran geçmişi göster, sonrasını bildirimle al
+    update_messages(view);
+    g_unix_fd_add(model_message_fd(((Controller *)controller)->model), G_IO_IN, on_message_ready, view);
 
-    printf("View initialized\n");
+    LOG_DEBUG(LOG_VIEW, "View initialized");
     return view;
 }
 
-void view_update_output(View *view, const char *output) {
+// xterm paleti: 16 temel renk, 6x6x6 küp ve 24 gri ton
+static void palette_color(int32_t color, char out[8]) {
+    static const char *const base[16] = {
+        "#000000", "#cd0000", "#00cd00", "#cdcd00", "#0000ee", "#cd00cd", "#00cdcd", "#e5e5e5",
+        "#7f7f7f", "#ff0000", "#00ff00", "#ffff00", "#5c5cff", "#ff00ff", "#00ffff", "#ffffff",
+    };
+    static const int levels[6] = { 0, 95, 135, 175, 215, 255 };
+    int r, g, b;
+    if (color & STYLE_RGB) {
+        r = (color >> 16) & 0xff;
+        g = (color >> 8) & 0xff;
+        b = color & 0xff;
+    } else if (color < 16) {
+        strcpy(out, base[color]);
+        return;
+    } else if (color < 232) {
+        r = levels[(color - 16) / 36];
+        g = levels[(color - 16) / 6 % 6];
+        b = levels[(color - 16) % 6];
+    } else {
+        r = g = b = 8 + (color - 232) * 10;
+    }
+    snprintf(out, 8, "#%02x%02x%02x", r, g, b);
+}
+
+// SGR stili başına bir etiket; ilk kullanıldığında oluşturulur
+static GtkTextTag *style_tag(GtkTextBuffer *buffer, const TextStyle *style) {
+    char tag_name[48];
+    snprintf(tag_name, sizeof(tag_name), "sgr:%x:%x:%x", (unsigned)style->fg, (unsigned)style->bg, style->flags);
+    GtkTextTag *tag = gtk_text_tag_table_lookup(gtk_text_buffer_get_tag_table(buffer), tag_name);
+    if (tag) return tag;
+
+    tag = gtk_text_buffer_create_tag(buffer, tag_name, NULL);
+    char fg[8] = "", bg[8] = "";
+    if (style->fg != STYLE_DEFAULT) palette_color(style->fg, fg);
+    if (style->bg != STYLE_DEFAULT) palette_color(style->bg, bg);
+    if (style->flags & STYLE_INVERSE) {
+        // Varsayılan renkler CSS temasındaki yeşil üstüne siyah
+        char tmp[8];
+        strcpy(tmp, fg[0] ? fg : "#00ff00");
+        strcpy(fg, bg[0] ? bg : "#000000");
+        strcpy(bg, tmp);
+    }
+    if (fg[0]) g_object_set(G_OBJECT(tag), "foreground", fg, NULL);
+    if (bg[0]) g_object_set(G_OBJECT(tag), "background", bg, NULL);
+    if (style->flags & STYLE_BOLD) g_object_set(G_OBJECT(tag), "weight", PANGO_WEIGHT_BOLD, NULL);
+    if (style->flags & STYLE_ITALIC) g_object_set(G_OBJECT(tag), "style", PANGO_STYLE_ITALIC, NULL);
+    if (style->flags & STYLE_UNDERLINE) g_object_set(G_OBJECT(tag), "underline", PANGO_UNDERLINE_SINGLE, NULL);
+    return tag;
+}
+
+// Temizleyiciden gelen aynı stildeki metin parçası
+static void insert_run(const char *text, size_t len, const TextStyle *style, void *data) {
+    GtkTextBuffer *buffer = (GtkTextBuffer *)data;
+    GtkTextIter end;
+    gtk_text_buffer_get_end_iter(buffer, &end);
+    if (style_is_default(style)) {
+        gtk_text_buffer_insert(buffer, &end, text, (gint)len);
+    } else {
+        gtk_text_buffer_insert_with_tags(buffer, &end, text, (gint)len, style_tag(buffer, style), NULL);
+    }
+}
+
+// Yeni komut satırını bölmenin sonuna ekler; önceki çıktılar yerinde kalır
+void view_append_command(View *view, const char *command) {
     if (!view || !view->output_text) return;
-    Controller *ctrl = (Controller *)view->controller;
+    sanitizer_reset(view->sanitizer); // Önceki komutun rengi ya da yarım kaçışı taşınmasın
     GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view->output_text));
-    gtk_text_buffer_set_text(buffer, "", -1);
     GtkTextIter end;
     gtk_text_buffer_get_end_iter(buffer, &end);
+    gtk_text_buffer_insert(buffer, &end, "> ", -1);
+    gtk_text_buffer_insert(buffer, &end, command, -1);
+    gtk_text_buffer_insert(buffer, &end, "\n", -1);
+    trim_scrollback(view, buffer);
+}
 
-    for (int i = 0; i < ctrl->model->cmd_count; i++) {
-        char line[MAX_COMMAND + 10];
-        snprintf(line, sizeof(line), "> %s\n", ctrl->model->command_history[i]);
-        gtk_text_buffer_insert(buffer, &end, line, -1);
-    }
-    gtk_text_buffer_insert(buffer, &end, output, -1);
-    printf("Output updated: %s\n", output);
+// Ham bayt akışı: geçersiz UTF-8 ve renk kaçışları GTK'ya ulaşmadan çözülür
+void view_append_output(View *view, const char *output, size_t len) {
+    if (!view || !view->output_text || len == 0) return;
+    GtkTextBuffer *buffer = gtk_text_view_get_buffer(GTK_TEXT_VIEW(view->output_text));
+    sanitizer_feed(view->sanitizer, output, len, insert_run, buffer);
+    trim_scrollback(view, buffer);
+}
+
+void view_run(View *view) {
+    (void)view;
+    gtk_main();
+}
+
+// Pencerede komutlar beklenmeden girilebilir; bitişin ayrıca gösterilecek bir yeri yok
+void view_command_done(View *view) {
+    (void)view;
+}
+
+int view_is_headless(void) {
+    return 0;
 }
 
 void view_destroy(View *view) {
     if (!view) return;
     gtk_widget_destroy(view->window);
+    g_free(view->history_prefix);
+    sanitizer_free(view->sanitizer);
     free(view);
-    printf("View destroyed\n");
+    LOG_DEBUG(LOG_VIEW, "View destroyed");
 }
\ No newline at end of file
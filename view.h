@@ -1,24 +1,20 @@
 #ifndef VIEW_H
 #define VIEW_H
 
-#include <gtk/gtk.h>
+#include <stddef.h>
 
 #define BUF_SIZE 4096
-#define MAX_HISTORY 50
 
-typedef struct {
-    GtkWidget *window;
-    GtkWidget *output_text;
-    GtkWidget *message_text;
-    GtkWidget *entry;
-    char last_message[BUF_SIZE * MAX_HISTORY];
-    void (*on_command)(const char *input, void *data);
-    void *controller;
-} View;
+// Görünüm arka ucu bağlantı sırasında seçilir: view.c (GTK penceresi) ya da
+// view_headless.c (stdin'den komut, stdout'a çıktı). Denetleyici yalnızca bu arayüzü görür.
+typedef struct View View;
 
 View *view_init(void (*on_command)(const char *input, void *data), void *data);
-void view_update_output(View *view, const char *output);
-void view_append_message(View *view, const char *sender, const char *message);
+void view_run(View *view);
+void view_append_command(View *view, const char *command);
+void view_append_output(View *view, const char *output, size_t len);
+void view_command_done(View *view);
+int view_is_headless(void);
 void view_destroy(View *view);
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,170 @@
+#include "view.h"
+#include <errno.h>
+#include <glib-unix.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "controller.h"
+
+// Ekransız arka uç: stdin'den satır satır komut okur, çıktıyı ve gelen
+// mesajları stdout'a yazar. Bir satır bitmeden sonrakine geçilmez, böylece
+// betikler sıralı çalışır; stdin kapanıp son komut ve & ile başlatılan son
+// iş bitince döngüden çıkılır.
+struct View {
+    void (*on_command)(const char *input, void *data);
+    void *controller;
+    GMainLoop *loop;
+    GString *input;      // stdin'den okunmuş, henüz çalıştırılmamış satırlar
+    guint stdin_source;  // Komut sürerken 0: stdin okunmaz
+    guint resume_source;
+    int eof;
+};
+
+static int protocol_fd = STDOUT_FILENO;
+
+// Model ve denetleyici daha ilk printf'lerini atmadan asıl stdout ayrılır;
+// fd 1 stderr'a yönlenir ki hata ayıklama çıktısı protokole karışmasın
+__attribute__((constructor)) static void claim_stdout(void) {
+    int fd = dup(STDOUT_FILENO);
+    if (fd < 0) return;
+    protocol_fd = fd;
+    dup2(STDERR_FILENO, STDOUT_FILENO);
+}
+
+static void write_all(int fd, const char *data, size_t len) {
+    while (len > 0) {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return;
+        data += n;
+        len -= (size_t)n;
+    }
+}
+
+static void append_message(const MessageEntry *entry, void *data) {
+    char timestamp[32];
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", localtime(&entry->timestamp));
+    GString *line = g_string_new(NULL);
+    if (entry->type == 0) {
+        g_string_append_printf(line, "[%s] [%s] ", entry->sender, timestamp);
+        g_string_append_len(line, entry->data, (gssize)entry->data_size);
+        g_string_append(line, "\n");
+    } else {
+        g_string_append_printf(line, "[%s] File: %s (%llu bytes, id %llu)\n", entry->sender, entry->filename,
+                               (unsigned long long)entry->file_size, (unsigned long long)entry->seq);
+    }
+    write_all(protocol_fd, line->str, line->len);
+    g_string_free(line, TRUE);
+}
+
+static gboolean on_message_ready(gint fd, GIOCondition condition, gpointer data) {
+    View *view = (View *)data;
+    Controller *ctrl = (Controller *)view->controller;
+    model_message_ack(ctrl->model);
+    model_read_messages(ctrl->model, append_message, view);
+    return G_SOURCE_CONTINUE;
+}
+
+static gboolean on_stdin(gint fd, GIOCondition condition, gpointer data);
+
+// Tamponda bekleyen satırları çalıştırır; bir satır arka planda sürerse durur
+static void run_pending(View *view) {
+    Controller *ctrl = (Controller *)view->controller;
+    while (controller_idle(ctrl)) {
+        char *newline = memchr(view->input->str, '\n', view->input->len);
+        if (!newline && !(view->eof && view->input->len > 0)) break;
+        size_t len = newline ? (size_t)(newline - view->input->str) : view->input->len;
+        char *command = g_strndup(view->input->str, len);
+        g_string_erase(view->input, 0, (gssize)(newline ? len + 1 : len));
+        if (len > 0 && command[len - 1] == '\r') command[len - 1] = '\0';
+        view->on_command(command, view->controller);
+        g_free(command);
+    }
+}
+
+static gboolean on_stdin(gint fd, GIOCondition condition, gpointer data) {
+    View *view = (View *)data;
+    char buffer[BUF_SIZE];
+    ssize_t n = read(fd, buffer, sizeof(buffer));
+    if (n < 0 && (errno == EINTR || errno == EAGAIN)) return G_SOURCE_CONTINUE;
+    if (n > 0) g_string_append_len(view->input, buffer, n);
+    else view->eof = 1;
+
+    run_pending(view);
+    Controller *ctrl = (Controller *)view->controller;
+    if (controller_idle(ctrl)) {
+        if (!view->eof) return G_SOURCE_CONTINUE;
+        if (controller_jobs(ctrl) == 0) g_main_loop_quit(view->loop);
+    }
+    // Komut sürerken stdin okunmaz; view_command_done izlemeyi geri açar
+    view->stdin_source = 0;
+    return G_SOURCE_REMOVE;
+}
+
+static gboolean on_resume(gpointer data) {
+    View *view = (View *)data;
+    view->resume_source = 0;
+    run_pending(view);
+    Controller *ctrl = (Controller *)view->controller;
+    if (!controller_idle(ctrl)) return G_SOURCE_REMOVE;
+    if (view->eof) {
+        if (controller_jobs(ctrl) == 0) g_main_loop_quit(view->loop);
+    } else {
+        view->stdin_source = g_unix_fd_add(STDIN_FILENO, G_IO_IN | G_IO_HUP | G_IO_ERR, on_stdin, view);
+    }
+    return G_SOURCE_REMOVE;
+}
+
+// Denetleyicinin çağrı yığınından çıkıp sıradaki satıra boşta geçilir
+void view_command_done(View *view) {
+    if (view->stdin_source || view->resume_source) return;
+    view->resume_source = g_idle_add(on_resume, view);
+}
+
+View *view_init(void (*on_command)(const char *input, void *data), void *controller) {
+    View *view = calloc(1, sizeof(View));
+    if (!view) {
+        fprintf(stderr, "Failed to allocate View\n");
+        return NULL;
+    }
+    view->on_command = on_command;
+    view->controller = controller;
+    view->loop = g_main_loop_new(NULL, FALSE);
+    view->input = g_string_new(NULL);
+
+    Controller *ctrl = (Controller *)controller;
+    model_read_messages(ctrl->model, append_message, view);
+    g_unix_fd_add(model_message_fd(ctrl->model), G_IO_IN, on_message_ready, view);
+    view->stdin_source = g_unix_fd_add(STDIN_FILENO, G_IO_IN | G_IO_HUP | G_IO_ERR, on_stdin, view);
+    return view;
+}
+
+void view_run(View *view) {
+    g_main_loop_run(view->loop);
+}
+
+// Betik çıktısında komutun kendisi tekrarlanmaz
+void view_append_command(View *view, const char *command) {
+    (void)view;
+    (void)command;
+}
+
+// Ham baytlar olduğu gibi geçer; renk kaçışları okuyan programa kalır
+void view_append_output(View *view, const char *output, size_t len) {
+    write_all(protocol_fd, output, len);
+}
+
+int view_is_headless(void) {
+    return 1;
+}
+
+void view_destroy(View *view) {
+    if (!view) return;
+    if (view->stdin_source) g_source_remove(view->stdin_source);
+    if (view->resume_source) g_source_remove(view->resume_source);
+    g_main_loop_unref(view->loop);
+    g_string_free(view->input, TRUE);
+    free(view);
+}